@@ -1,5 +1,9 @@
+#ifdef NTLM_FIXED_LEN
+#include "ntlm_fixed_len.cl"
+#else
 #include "rt.cl"
 #include "string.cl"
+#endif
 
 
 __kernel void crackalack(
@@ -12,16 +16,27 @@ __kernel void crackalack(
     __global unsigned long *g_indices,
     __global unsigned int *g_pos_start) {
 
+#ifdef NTLM_FIXED_LEN
+  unsigned long index = g_indices[get_global_id(0)];
+  unsigned char plaintext[NTLM_FIXED_LEN];
+
+
+  for (unsigned int pos = *g_pos_start; pos < (*g_chain_len - 1); pos++) {
+    fixed_index_to_plaintext(index, plaintext);
+    index = fixed_hash_to_index(fixed_hash(plaintext), pos);
+  }
+
+  g_indices[get_global_id(0)] = index;
+#else
   unsigned int hash_type = *g_hash_type;
-  char charset[MAX_CHARSET_LEN];
-  unsigned int plaintext_len_min = *g_plaintext_len_min;
-  unsigned int plaintext_len_max = *g_plaintext_len_max;
+  unsigned int plaintext_len_min = TABLE_PARAM(TABLE_PLAINTEXT_LEN_MIN, *g_plaintext_len_min);
+  unsigned int plaintext_len_max = TABLE_PARAM(TABLE_PLAINTEXT_LEN_MAX, *g_plaintext_len_max);
   unsigned int reduction_offset = *g_reduction_offset;
   unsigned int chain_len = *g_chain_len;
   unsigned long start_index = g_indices[get_global_id(0)];
   unsigned int pos = *g_pos_start;
 
-  unsigned int charset_len = g_strncpy(charset, g_charset, sizeof(charset));
+  DECLARE_CHARSET(g_charset);
   unsigned long plaintext_space_up_to_index[MAX_PLAINTEXT_LEN];
   unsigned char plaintext[MAX_PLAINTEXT_LEN];
   unsigned int plaintext_len = 0;
@@ -47,5 +62,6 @@ __kernel void crackalack(
         &plaintext_len,
         hash,
         &hash_len);
+#endif
   return;
 }
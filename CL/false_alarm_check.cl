@@ -1,5 +1,9 @@
 #include "shared.h"
+#ifdef NTLM_FIXED_LEN
+#include "ntlm_fixed_len.cl"
+#else
 #include "rt.cl"
+#endif
 
 __kernel void false_alarm_check(
     __global unsigned int *g_hash_type,
@@ -9,34 +13,56 @@ __kernel void false_alarm_check(
     __global unsigned int *g_reduction_offset,
     __global unsigned long *g_plaintext_space_total,
     __global unsigned long *g_plaintext_space_up_to_index,
-    __global unsigned int *g_device_num,
-    __global unsigned int *g_total_devices,
     __global unsigned int *g_num_start_indices,
     __global unsigned long *g_start_indices,
     __global unsigned int *g_start_index_positions,
     __global unsigned long *g_hash_base_indices,
-    __global unsigned int *g_exec_block_scaler,
     __global unsigned long *g_plaintext_indices) {
 
-  int index_pos = (*g_num_start_indices - *g_device_num) - ((get_global_id(0) + *g_exec_block_scaler) * *g_total_devices) - 1;
-  if (index_pos < 0)
+  /* The host uploads one chunk of this device's potential start indices at a time;
+   * each work item checks one of them.  The output buffer is re-used for every chunk,
+   * so a result is written whether or not the chain matched. */
+  unsigned int index_pos = get_global_id(0);
+  if (index_pos >= *g_num_start_indices)
     return;
 
-  char charset[MAX_CHARSET_LEN];
+  g_plaintext_indices[index_pos] = 0;
+
+#ifdef NTLM_FIXED_LEN
+  unsigned char plaintext[NTLM_FIXED_LEN];
+  unsigned long index = g_start_indices[index_pos], previous_index = 0;
+  unsigned long hash_base_index = g_hash_base_indices[index_pos] % FIXED_PLAINTEXT_SPACE_TOTAL;
+  unsigned int endpoint = g_start_index_positions[index_pos];
+
+  for (unsigned int pos = 0; pos < endpoint + 1; pos++) {
+    fixed_index_to_plaintext(index, plaintext);
+
+    previous_index = index;
+    index = fixed_hash_to_index(fixed_hash(plaintext), pos);
+
+    if ((index == (hash_base_index + pos)) || (index == (hash_base_index + pos - FIXED_PLAINTEXT_SPACE_TOTAL))) {
+      g_plaintext_indices[index_pos] = previous_index;
+      return;
+    }
+  }
+#else
   unsigned char plaintext[MAX_PLAINTEXT_LEN];
   unsigned char hash[MAX_HASH_OUTPUT_LEN];
   unsigned int plaintext_len;
   unsigned int hash_len;
 
-  unsigned int charset_len = g_strncpy(charset, g_charset, sizeof(charset));
+  DECLARE_CHARSET(g_charset);
   unsigned int hash_type = *g_hash_type;
-  unsigned int plaintext_len_min = *g_plaintext_len_min;
-  unsigned int plaintext_len_max = *g_plaintext_len_max;
+  unsigned int plaintext_len_min = TABLE_PARAM(TABLE_PLAINTEXT_LEN_MIN, *g_plaintext_len_min);
+  unsigned int plaintext_len_max = TABLE_PARAM(TABLE_PLAINTEXT_LEN_MAX, *g_plaintext_len_max);
   unsigned int reduction_offset = *g_reduction_offset;
-  unsigned long plaintext_space_total = *g_plaintext_space_total;
+  unsigned long plaintext_space_total = TABLE_PARAM(TABLE_PLAINTEXT_SPACE_TOTAL, *g_plaintext_space_total);
   unsigned long plaintext_space_up_to_index[MAX_PLAINTEXT_LEN];
+  fast_div charset_len_div, plaintext_space_total_div;
 
   copy_plaintext_space_up_to_index(plaintext_space_up_to_index, g_plaintext_space_up_to_index);
+  fast_div_init(&charset_len_div, charset_len);
+  fast_div_init(&plaintext_space_total_div, plaintext_space_total);
 
   unsigned long index = g_start_indices[index_pos], previous_index = 0;
   unsigned long hash_base_index = g_hash_base_indices[index_pos] % plaintext_space_total;
@@ -44,15 +70,16 @@ __kernel void false_alarm_check(
 
 
   for (unsigned int pos = 0; pos < endpoint + 1; pos++) {
-    index_to_plaintext(index, charset, charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, &plaintext_len);
+    index_to_plaintext(index, charset, &charset_len_div, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, &plaintext_len);
     do_hash(hash_type, plaintext, plaintext_len, hash, &hash_len);
 
     previous_index = index;
-    index = hash_to_index(hash, hash_len, reduction_offset, plaintext_space_total, pos);
+    index = hash_to_index(hash, hash_len, reduction_offset, &plaintext_space_total_div, pos);
 
     if ((index == (hash_base_index + pos)) || (index == (hash_base_index + pos - plaintext_space_total))) {
       g_plaintext_indices[index_pos] = previous_index;
       return;
     }
   }
+#endif
 }
@@ -0,0 +1,65 @@
+// Division of 64-bit integers by a fixed divisor using a multiplication and a shift.
+// This is the same algorithm as in fast_div.c on the host; see that file for details.
+// The constants are computed once per work item, which is negligible next to the
+// thousands of chain steps each work item performs.
+
+typedef struct {
+  unsigned long divisor;
+  unsigned long magic;  // 0 when the divisor is a power of two.
+  unsigned int shift;
+  unsigned int add;     // 1 when the magic number needed a 65th bit.
+} fast_div;
+
+
+inline void fast_div_init(fast_div *fd, unsigned long divisor) {
+  unsigned long proposed_magic = 0, remainder = 0, carry = 0;
+  unsigned int floor_log2 = 63 - clz(divisor);
+
+  fd->divisor = divisor;
+  fd->magic = 0;
+  fd->shift = floor_log2;
+  fd->add = 0;
+
+  // Powers of two are a plain shift.
+  if ((divisor & (divisor - 1)) == 0)
+    return;
+
+  // Long division of 2^(64 + floor_log2) by the divisor.
+  remainder = 1UL << floor_log2;
+  for (int i = 0; i < 64; i++) {
+    carry = remainder >> 63;
+    remainder <<= 1;
+    proposed_magic <<= 1;
+    if (carry || (remainder >= divisor)) {
+      remainder -= divisor;
+      proposed_magic |= 1;
+    }
+  }
+
+  if ((divisor - remainder) >= (1UL << floor_log2)) {
+    proposed_magic += proposed_magic;
+    if (((remainder + remainder) >= divisor) || ((remainder + remainder) < remainder))
+      proposed_magic++;
+    fd->add = 1;
+  }
+  fd->magic = proposed_magic + 1;
+}
+
+
+// Returns n / fd->divisor.
+inline unsigned long fast_div_quotient(unsigned long n, fast_div *fd) {
+  if (fd->magic == 0)
+    return n >> fd->shift;
+
+  unsigned long q = mul_hi(n, fd->magic);
+  if (fd->add)
+    return (((n - q) >> 1) + q) >> fd->shift;
+  else
+    return q >> fd->shift;
+}
+
+
+// Returns n % fd->divisor.
+inline unsigned long fast_div_remainder(unsigned long n, fast_div *fd) {
+  return n - (fast_div_quotient(n, fd) * fd->divisor);
+}
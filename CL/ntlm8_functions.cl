@@ -1,3 +1,5 @@
+#include "shared.h"
+
 __constant char charset[] = " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
 
 
@@ -168,7 +170,7 @@ inline unsigned long hash_ntlm8(unsigned char *plaintext) {
 
 
 inline unsigned long hash_to_index_ntlm8(unsigned long hash, unsigned int pos) {
-  return (hash + pos) % 6634204312890625UL;
+  return (hash + pos) % NTLM8_PLAINTEXT_SPACE_TOTAL;
 }
 
 
@@ -189,5 +191,5 @@ inline unsigned long hash_char_to_index_ntlm8(__global unsigned char *hash_value
   ret <<= 8;
   ret |= hash_value[0];
 
-  return (ret + pos) % 6634204312890625UL;
+  return (ret + pos) % NTLM8_PLAINTEXT_SPACE_TOTAL;
 }
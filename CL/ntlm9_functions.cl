@@ -47,9 +47,9 @@ inline unsigned long hash_to_index_ntlm9(unsigned long hash, unsigned int pos) {
   tmp   = ((hash >> 58) * 29) >> 6; // just right
   //tmp = ((hash >> 58) * 58) >> 7; // overkill
 
-  hash -= 630249409724609375UL * tmp;
-  if (hash >= 630249409724609375UL) {
-    hash -= 630249409724609375UL;
+  hash -= NTLM9_PLAINTEXT_SPACE_TOTAL * tmp;
+  if (hash >= NTLM9_PLAINTEXT_SPACE_TOTAL) {
+    hash -= NTLM9_PLAINTEXT_SPACE_TOTAL;
   }
 
   return hash;
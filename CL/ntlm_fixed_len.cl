@@ -0,0 +1,28 @@
+// Selects the hand-optimized NTLM8 or NTLM9 functions when the host builds a kernel
+// with -DNTLM_FIXED_LEN=8 or -DNTLM_FIXED_LEN=9 (see get_table_build_options()).  The
+// crackalack, precompute, and false_alarm_check kernels use these in place of the
+// generic chain functions.
+
+#if NTLM_FIXED_LEN == 8
+#include "ntlm8_functions.cl"
+
+#define FIXED_CHAIN_LEN NTLM8_CHAIN_LEN
+#define FIXED_PLAINTEXT_SPACE_TOTAL NTLM8_PLAINTEXT_SPACE_TOTAL
+#define fixed_index_to_plaintext(_index, _plaintext) index_to_plaintext_ntlm8(_index, charset, _plaintext)
+#define fixed_hash(_plaintext) hash_ntlm8(_plaintext)
+#define fixed_hash_to_index(_hash, _pos) hash_to_index_ntlm8(_hash, _pos)
+#define fixed_hash_char_to_index(_g_hash, _pos) hash_char_to_index_ntlm8(_g_hash, _pos)
+
+#elif NTLM_FIXED_LEN == 9
+#include "ntlm9_functions.cl"
+
+#define FIXED_CHAIN_LEN NTLM9_CHAIN_LEN
+#define FIXED_PLAINTEXT_SPACE_TOTAL NTLM9_PLAINTEXT_SPACE_TOTAL
+#define fixed_index_to_plaintext(_index, _plaintext) index_to_plaintext_ntlm9(_index, _plaintext)
+#define fixed_hash(_plaintext) hash_ntlm9(_plaintext)
+#define fixed_hash_to_index(_hash, _pos) hash_to_index_ntlm9(_hash, _pos)
+#define fixed_hash_char_to_index(_g_hash, _pos) hash_char_to_index_ntlm9(_g_hash, _pos)
+
+#else
+#error "NTLM_FIXED_LEN must be 8 or 9."
+#endif
@@ -1,5 +1,9 @@
+#ifdef NTLM_FIXED_LEN
+#include "ntlm_fixed_len.cl"
+#else
 #include "string.cl"
 #include "rt.cl"
+#endif
 
 __kernel void precompute(
     __global unsigned int *g_hash_type,
@@ -15,14 +19,32 @@ __kernel void precompute(
     __global unsigned int *g_exec_block_scaler,
     __global unsigned long *g_output) {
 
-  long target_chain_len = (*g_chain_len - *g_device_num) - ((get_global_id(0) + *g_exec_block_scaler) * *g_total_devices) - 1;
+#ifdef NTLM_FIXED_LEN
+  long target_chain_len = (FIXED_CHAIN_LEN - *g_device_num) - ((get_global_id(0) + *g_exec_block_scaler) * *g_total_devices) - 1;
+
+  if (target_chain_len < 1) {
+    g_output[get_global_id(0)] = 0;
+    return;
+  }
+
+  unsigned char plaintext[NTLM_FIXED_LEN];
+  unsigned long index = fixed_hash_char_to_index(g_hash, target_chain_len - 1);
+
+  for(unsigned int i = target_chain_len; i < FIXED_CHAIN_LEN - 1; i++) {
+    fixed_index_to_plaintext(index, plaintext);
+    index = fixed_hash_to_index(fixed_hash(plaintext), i);
+  }
+
+  g_output[get_global_id(0)] = index;
+#else
+  unsigned int chain_len = TABLE_PARAM(TABLE_CHAIN_LEN, *g_chain_len);
+  long target_chain_len = (chain_len - *g_device_num) - ((get_global_id(0) + *g_exec_block_scaler) * *g_total_devices) - 1;
 
   if (target_chain_len < 1) {
     g_output[get_global_id(0)] = 0;
     return;
   }
 
-  char charset[MAX_CHARSET_LEN];
   unsigned long plaintext_space_up_to_index[MAX_PLAINTEXT_LEN];
   unsigned char hash[MAX_HASH_OUTPUT_LEN];
   unsigned char plaintext[MAX_PLAINTEXT_LEN];
@@ -31,22 +53,26 @@ __kernel void precompute(
 
   unsigned int hash_type = *g_hash_type;
   unsigned int hash_len = *g_hash_len;
-  unsigned int charset_len = g_strncpy(charset, g_charset, sizeof(charset));
-  unsigned int plaintext_len_min = *g_plaintext_len_min;
-  unsigned int plaintext_len_max = *g_plaintext_len_max;
+  DECLARE_CHARSET(g_charset);
+  unsigned int plaintext_len_min = TABLE_PARAM(TABLE_PLAINTEXT_LEN_MIN, *g_plaintext_len_min);
+  unsigned int plaintext_len_max = TABLE_PARAM(TABLE_PLAINTEXT_LEN_MAX, *g_plaintext_len_max);
   unsigned int reduction_offset = TABLE_INDEX_TO_REDUCTION_OFFSET(*g_table_index);
-  unsigned int chain_len = *g_chain_len;
   unsigned long plaintext_space_total = fill_plaintext_space_table(charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index);
+  fast_div charset_len_div, plaintext_space_total_div;
+
+  fast_div_init(&charset_len_div, charset_len);
+  fast_div_init(&plaintext_space_total_div, plaintext_space_total);
 
 
   g_memcpy(hash, g_hash, *g_hash_len);
-  index = hash_to_index(hash, hash_len, reduction_offset, plaintext_space_total, target_chain_len - 1);
+  index = hash_to_index(hash, hash_len, reduction_offset, &plaintext_space_total_div, target_chain_len - 1);
 
   for(unsigned int i = target_chain_len; i < chain_len - 1; i++) {
-    index_to_plaintext(index, charset, charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, &plaintext_len);
+    index_to_plaintext(index, charset, &charset_len_div, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, &plaintext_len);
     do_hash(hash_type, plaintext, plaintext_len, hash, &hash_len);
-    index = hash_to_index(hash, hash_len, reduction_offset, plaintext_space_total, i);
+    index = hash_to_index(hash, hash_len, reduction_offset, &plaintext_space_total_div, i);
   }
 
   g_output[get_global_id(0)] = index;
+#endif
 }
@@ -1,5 +1,8 @@
 #include "shared.h"
+#include "fast_div.cl"
 #include "ntlm.cl"
+#include "md5.cl"
+#include "sha1.cl"
 
 #ifdef USE_DES_BITSLICE
 #include "des_bs.cl"
@@ -7,7 +10,30 @@
 #include "des.cl"
 #endif
 
-inline void index_to_plaintext(unsigned long index, char *charset, unsigned int charset_len, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned long *plaintext_space_up_to_index, unsigned char *plaintext, unsigned int *plaintext_len) {
+// When the host compiles a table's parameters in as build options (see
+// get_table_build_options()), TABLE_PARAM() selects the constant so that the compiler
+// can fold the divisions and unroll the loops that depend on it.  Otherwise, the value
+// from the kernel argument is used.  The charset is then kept in constant memory.
+#ifdef TABLE_CHARSET
+__constant char table_charset[] = TABLE_CHARSET;
+
+#define TABLE_PARAM(_constant, _runtime) (_constant)
+#define CHARSET_SPACE __constant
+#define DECLARE_CHARSET(_g_charset) \
+  __constant char *charset = table_charset; \
+  unsigned int charset_len = TABLE_CHARSET_LEN
+#else
+#define TABLE_PARAM(_constant, _runtime) (_runtime)
+#define CHARSET_SPACE
+#define DECLARE_CHARSET(_g_charset) \
+  char charset[MAX_CHARSET_LEN]; \
+  unsigned int charset_len = g_strncpy(charset, _g_charset, sizeof(charset))
+#endif
+
+
+// Unless the charset length is a constant, the divisions by it are done with its
+// pre-computed reciprocal.
+inline void index_to_plaintext(unsigned long index, CHARSET_SPACE char *charset, fast_div *charset_len_div, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned long *plaintext_space_up_to_index, unsigned char *plaintext, unsigned int *plaintext_len) {
   for (int i = plaintext_len_max - 1; i >= plaintext_len_min - 1; i--) {
     if (index >= plaintext_space_up_to_index[i]) {
       *plaintext_len = i + 1;
@@ -17,8 +43,14 @@ inline void index_to_plaintext(unsigned long index, char *charset, unsigned int
 
   unsigned long index_x = index - plaintext_space_up_to_index[*plaintext_len - 1];
   for (int i = *plaintext_len - 1; i >= 0; i--) {
-    plaintext[i] = charset[index_x % charset_len];
-    index_x = index_x / charset_len;
+#ifdef TABLE_CHARSET_LEN
+    plaintext[i] = charset[index_x % TABLE_CHARSET_LEN];
+    index_x = index_x / TABLE_CHARSET_LEN;
+#else
+    unsigned long quotient = fast_div_quotient(index_x, charset_len_div);
+    plaintext[i] = charset[index_x - (quotient * charset_len_div->divisor)];
+    index_x = quotient;
+#endif
   }
 
   return;
@@ -44,13 +76,23 @@ inline void do_hash(unsigned int hash_type, unsigned char *plaintext, unsigned i
 #elif HASH_TYPE == HASH_NTLM
   ntlm_hash(plaintext, plaintext_len, hash_value /*, g_debug*/);
   *hash_len = 16;
+
+#elif HASH_TYPE == HASH_MD5
+  md5_hash(plaintext, plaintext_len, hash_value);
+  *hash_len = 16;
+
+#elif HASH_TYPE == HASH_SHA1
+  sha1_hash(plaintext, plaintext_len, hash_value);
+  *hash_len = 20;
 #endif
 
   return;
 }
 
 
-inline unsigned long hash_to_index(unsigned char *hash_value, unsigned int hash_len, unsigned int reduction_offset, unsigned long plaintext_space_total, unsigned int pos) {
+// Unless the plaintext space total is a constant, the modulus is done with its
+// pre-computed reciprocal.
+inline unsigned long hash_to_index(unsigned char *hash_value, unsigned int hash_len, unsigned int reduction_offset, fast_div *plaintext_space_total_div, unsigned int pos) {
   unsigned long ret = hash_value[7];
   ret <<= 8;
   ret |= hash_value[6];
@@ -67,7 +109,11 @@ inline unsigned long hash_to_index(unsigned char *hash_value, unsigned int hash_
   ret <<= 8;
   ret |= hash_value[0];
 
-  return (ret + reduction_offset + pos) % plaintext_space_total;
+#ifdef TABLE_PLAINTEXT_SPACE_TOTAL
+  return (ret + reduction_offset + pos) % TABLE_PLAINTEXT_SPACE_TOTAL;
+#else
+  return fast_div_remainder(ret + reduction_offset + pos, plaintext_space_total_div);
+#endif
 }
 
 
@@ -95,7 +141,7 @@ inline void copy_plaintext_space_up_to_index(unsigned long *dest, __global unsig
 
 inline unsigned long generate_rainbow_chain(
     unsigned int hash_type,
-    char *charset,
+    CHARSET_SPACE char *charset,
     unsigned int charset_len,
     unsigned int plaintext_len_min,
     unsigned int plaintext_len_max,
@@ -111,10 +157,14 @@ inline unsigned long generate_rainbow_chain(
     unsigned int *hash_len) {
 
   unsigned long index = start;
+  fast_div charset_len_div, plaintext_space_total_div;
+
+  fast_div_init(&charset_len_div, charset_len);
+  fast_div_init(&plaintext_space_total_div, plaintext_space_total);
   for (; pos < chain_len - 1; pos++) {
-    index_to_plaintext(index, charset, charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, plaintext_len);
+    index_to_plaintext(index, charset, &charset_len_div, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, plaintext_len);
     do_hash(hash_type, plaintext, *plaintext_len, hash, hash_len);
-    index = hash_to_index(hash, *hash_len, reduction_offset, plaintext_space_total, pos);
+    index = hash_to_index(hash, *hash_len, reduction_offset, &plaintext_space_total_div, pos);
   }
   return index;
 }
@@ -0,0 +1,74 @@
+/* Searches a chunk of a rainbow table for the precomputed end indices of all hashes.
+ * The precomputed end indices are sorted on the host once, and stay on the device for
+ * all tables; each table's end indices are then streamed in.  Each work item takes one
+ * chain of the table and binary searches the precomputed end indices for it.
+ *
+ * Matches are appended to g_hits with an atomic counter.  If there are more than
+ * *g_max_hits of them, the counter still holds the total, so the host can re-run the
+ * chunk with a larger buffer. */
+
+/* Must match rt_tagged_end_index in rt_search.h. */
+typedef struct {
+  unsigned long end_index;
+  unsigned int hash_number;
+  unsigned int position;
+} tagged_end_index;
+
+/* Must match gpu_search_hit in crackalack_lookup.c. */
+typedef struct {
+  unsigned int hash_number;
+  unsigned int position;
+  unsigned int chain;
+} search_hit;
+
+
+__kernel void search_table(
+    __global tagged_end_index *g_sorted_end_indices,
+    __global unsigned int *g_num_sorted_end_indices,
+    __global unsigned char *g_cracked,
+    __global unsigned long *g_table_end_indices,
+    __global unsigned int *g_num_table_end_indices,
+    __global unsigned int *g_first,
+    __global unsigned int *g_chain_offset,
+    __global unsigned int *g_max_hits,
+    __global unsigned int *g_num_hits,
+    __global search_hit *g_hits) {
+
+  unsigned int i = get_global_id(0) + *g_first;
+  unsigned int num_sorted_end_indices = *g_num_sorted_end_indices;
+  unsigned int low = 0, high = num_sorted_end_indices, mid = 0, hit = 0;
+  unsigned long end_index = 0;
+
+
+  if (i >= *g_num_table_end_indices)
+    return;
+
+  /* As with the searches on the host, only the first chain with a given end index is
+   * used.  (When this chunk doesn't start at the first chain, the host includes the
+   * chain before it, so this comparison works at the chunk's start too.) */
+  end_index = g_table_end_indices[i];
+  if ((i > 0) && (g_table_end_indices[i - 1] == end_index))
+    return;
+
+  /* Find the first precomputed end index that is not less than this one. */
+  while (low < high) {
+    mid = low + ((high - low) / 2);
+    if (g_sorted_end_indices[mid].end_index < end_index)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  /* Every precomputed end index equal to this one is a match. */
+  for (; (low < num_sorted_end_indices) && (g_sorted_end_indices[low].end_index == end_index); low++) {
+    if (g_cracked[g_sorted_end_indices[low].hash_number])
+      continue;
+
+    hit = atomic_inc(g_num_hits);
+    if (hit < *g_max_hits) {
+      g_hits[hit].hash_number = g_sorted_end_indices[low].hash_number;
+      g_hits[hit].position = g_sorted_end_indices[low].position;
+      g_hits[hit].chain = *g_chain_offset + i;
+    }
+  }
+}
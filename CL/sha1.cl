@@ -0,0 +1,137 @@
+// Single-block SHA-1 (FIPS 180-4).  This matches sha1_encrypt() and sha1_hash() in the
+// host code.
+
+#define SHA1_F1(x, y, z)	bitselect((z), (y), (x))
+#define SHA1_F2(x, y, z)	((x) ^ (y) ^ (z))
+#define SHA1_F3(x, y, z)	bitselect((x), (y), ((x) ^ (z)))
+
+// Expands the message schedule in place: W holds the last 16 words, so word t is
+// stored over word t - 16.
+#define SHA1_W(W, t, t3, t8, t14) \
+	(W[t] = rotate(W[t3] ^ W[t8] ^ W[t14] ^ W[t], 1U))
+
+#define SHA1_STEP(f, k, a, b, c, d, e, x) \
+	(e) += rotate((a), 5U) + f((b), (c), (d)) + (k) + (x); \
+	(b) = rotate((b), 30U)
+
+inline void sha1_encrypt(__private uint *hash, __private uint *W) {
+  uint a = 0x67452301, b = 0xefcdab89, c = 0x98badcfe, d = 0x10325476, e = 0xc3d2e1f0;
+
+  // Steps 0 - 19
+  SHA1_STEP(SHA1_F1, 0x5a827999, a, b, c, d, e, W[0]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, e, a, b, c, d, W[1]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, d, e, a, b, c, W[2]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, c, d, e, a, b, W[3]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, b, c, d, e, a, W[4]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, a, b, c, d, e, W[5]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, e, a, b, c, d, W[6]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, d, e, a, b, c, W[7]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, c, d, e, a, b, W[8]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, b, c, d, e, a, W[9]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, a, b, c, d, e, W[10]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, e, a, b, c, d, W[11]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, d, e, a, b, c, W[12]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, c, d, e, a, b, W[13]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, b, c, d, e, a, W[14]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, a, b, c, d, e, W[15]);
+  SHA1_STEP(SHA1_F1, 0x5a827999, e, a, b, c, d, SHA1_W(W, 0, 13, 8, 2));
+  SHA1_STEP(SHA1_F1, 0x5a827999, d, e, a, b, c, SHA1_W(W, 1, 14, 9, 3));
+  SHA1_STEP(SHA1_F1, 0x5a827999, c, d, e, a, b, SHA1_W(W, 2, 15, 10, 4));
+  SHA1_STEP(SHA1_F1, 0x5a827999, b, c, d, e, a, SHA1_W(W, 3, 0, 11, 5));
+
+  // Steps 20 - 39
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, a, b, c, d, e, SHA1_W(W, 4, 1, 12, 6));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, e, a, b, c, d, SHA1_W(W, 5, 2, 13, 7));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, d, e, a, b, c, SHA1_W(W, 6, 3, 14, 8));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, c, d, e, a, b, SHA1_W(W, 7, 4, 15, 9));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, b, c, d, e, a, SHA1_W(W, 8, 5, 0, 10));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, a, b, c, d, e, SHA1_W(W, 9, 6, 1, 11));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, e, a, b, c, d, SHA1_W(W, 10, 7, 2, 12));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, d, e, a, b, c, SHA1_W(W, 11, 8, 3, 13));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, c, d, e, a, b, SHA1_W(W, 12, 9, 4, 14));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, b, c, d, e, a, SHA1_W(W, 13, 10, 5, 15));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, a, b, c, d, e, SHA1_W(W, 14, 11, 6, 0));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, e, a, b, c, d, SHA1_W(W, 15, 12, 7, 1));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, d, e, a, b, c, SHA1_W(W, 0, 13, 8, 2));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, c, d, e, a, b, SHA1_W(W, 1, 14, 9, 3));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, b, c, d, e, a, SHA1_W(W, 2, 15, 10, 4));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, a, b, c, d, e, SHA1_W(W, 3, 0, 11, 5));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, e, a, b, c, d, SHA1_W(W, 4, 1, 12, 6));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, d, e, a, b, c, SHA1_W(W, 5, 2, 13, 7));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, c, d, e, a, b, SHA1_W(W, 6, 3, 14, 8));
+  SHA1_STEP(SHA1_F2, 0x6ed9eba1, b, c, d, e, a, SHA1_W(W, 7, 4, 15, 9));
+
+  // Steps 40 - 59
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, a, b, c, d, e, SHA1_W(W, 8, 5, 0, 10));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, e, a, b, c, d, SHA1_W(W, 9, 6, 1, 11));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, d, e, a, b, c, SHA1_W(W, 10, 7, 2, 12));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, c, d, e, a, b, SHA1_W(W, 11, 8, 3, 13));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, b, c, d, e, a, SHA1_W(W, 12, 9, 4, 14));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, a, b, c, d, e, SHA1_W(W, 13, 10, 5, 15));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, e, a, b, c, d, SHA1_W(W, 14, 11, 6, 0));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, d, e, a, b, c, SHA1_W(W, 15, 12, 7, 1));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, c, d, e, a, b, SHA1_W(W, 0, 13, 8, 2));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, b, c, d, e, a, SHA1_W(W, 1, 14, 9, 3));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, a, b, c, d, e, SHA1_W(W, 2, 15, 10, 4));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, e, a, b, c, d, SHA1_W(W, 3, 0, 11, 5));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, d, e, a, b, c, SHA1_W(W, 4, 1, 12, 6));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, c, d, e, a, b, SHA1_W(W, 5, 2, 13, 7));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, b, c, d, e, a, SHA1_W(W, 6, 3, 14, 8));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, a, b, c, d, e, SHA1_W(W, 7, 4, 15, 9));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, e, a, b, c, d, SHA1_W(W, 8, 5, 0, 10));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, d, e, a, b, c, SHA1_W(W, 9, 6, 1, 11));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, c, d, e, a, b, SHA1_W(W, 10, 7, 2, 12));
+  SHA1_STEP(SHA1_F3, 0x8f1bbcdc, b, c, d, e, a, SHA1_W(W, 11, 8, 3, 13));
+
+  // Steps 60 - 79
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, a, b, c, d, e, SHA1_W(W, 12, 9, 4, 14));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, e, a, b, c, d, SHA1_W(W, 13, 10, 5, 15));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, d, e, a, b, c, SHA1_W(W, 14, 11, 6, 0));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, c, d, e, a, b, SHA1_W(W, 15, 12, 7, 1));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, b, c, d, e, a, SHA1_W(W, 0, 13, 8, 2));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, a, b, c, d, e, SHA1_W(W, 1, 14, 9, 3));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, e, a, b, c, d, SHA1_W(W, 2, 15, 10, 4));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, d, e, a, b, c, SHA1_W(W, 3, 0, 11, 5));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, c, d, e, a, b, SHA1_W(W, 4, 1, 12, 6));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, b, c, d, e, a, SHA1_W(W, 5, 2, 13, 7));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, a, b, c, d, e, SHA1_W(W, 6, 3, 14, 8));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, e, a, b, c, d, SHA1_W(W, 7, 4, 15, 9));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, d, e, a, b, c, SHA1_W(W, 8, 5, 0, 10));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, c, d, e, a, b, SHA1_W(W, 9, 6, 1, 11));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, b, c, d, e, a, SHA1_W(W, 10, 7, 2, 12));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, a, b, c, d, e, SHA1_W(W, 11, 8, 3, 13));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, e, a, b, c, d, SHA1_W(W, 12, 9, 4, 14));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, d, e, a, b, c, SHA1_W(W, 13, 10, 5, 15));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, c, d, e, a, b, SHA1_W(W, 14, 11, 6, 0));
+  SHA1_STEP(SHA1_F2, 0xca62c1d6, b, c, d, e, a, SHA1_W(W, 15, 12, 7, 1));
+
+  hash[0] = a + 0x67452301;
+  hash[1] = b + 0xefcdab89;
+  hash[2] = c + 0x98badcfe;
+  hash[3] = d + 0x10325476;
+  hash[4] = e + 0xc3d2e1f0;
+}
+
+
+inline void sha1_hash(unsigned char *plaintext, unsigned int plaintext_len, unsigned char *hash) {
+  unsigned int key[16] = {0};
+  unsigned int output[5];
+
+
+  if (plaintext_len > 55)
+    plaintext_len = 55;
+
+  for (int i = 0; i < plaintext_len; i++)
+    key[i / 4] |= ((uint)plaintext[i]) << (24 - ((i % 4) * 8));
+  key[plaintext_len / 4] |= 0x80 << (24 - ((plaintext_len % 4) * 8));
+  key[15] = plaintext_len << 3;
+
+  sha1_encrypt(output, key);
+
+  for (int i = 0; i < 5; i++) {
+    hash[(i * 4) + 0] = ((output[i] >> 24) & 0xff);
+    hash[(i * 4) + 1] = ((output[i] >> 16) & 0xff);
+    hash[(i * 4) + 2] = ((output[i] >> 8) & 0xff);
+    hash[(i * 4) + 3] = ((output[i] >> 0) & 0xff);
+  }
+}
@@ -26,6 +26,9 @@ __kernel void test_hash_to_index(
 
   unsigned long plaintext_space_total = fill_plaintext_space_table(charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index);
 
-  *g_index = hash_to_index(hash, hash_len, reduction_offset, plaintext_space_total, pos);
+  fast_div plaintext_space_total_div;
+  fast_div_init(&plaintext_space_total_div, plaintext_space_total);
+
+  *g_index = hash_to_index(hash, hash_len, reduction_offset, &plaintext_space_total_div, pos);
   return;
 }
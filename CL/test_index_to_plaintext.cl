@@ -25,7 +25,10 @@ __kernel void test_index_to_plaintext(
 
   fill_plaintext_space_table(charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index);
 
-  index_to_plaintext(index, charset, charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, &plaintext_len);
+  fast_div charset_len_div;
+  fast_div_init(&charset_len_div, charset_len);
+
+  index_to_plaintext(index, charset, &charset_len_div, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, &plaintext_len);
 
   *g_plaintext_len = plaintext_len;
   for (int i = 0; i < plaintext_len; i++)
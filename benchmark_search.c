@@ -0,0 +1,158 @@
+/*
+ * Rainbow Crackalack: benchmark_search.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Measures how many end index lookups per second each table search method does on a
+ * synthetic table: the original recursive binary search, one search tree lookup at a
+ * time, and batched search tree lookups (the method that crackalack_lookup uses).  The
+ * search tree is tested at each SIMD level that this CPU supports. */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "clock.h"
+#include "cpu_features.h"
+#include "rt_search.h"
+
+
+#define DEFAULT_NUM_CHAINS (16 * 1024 * 1024)
+#define DEFAULT_NUM_QUERIES (4 * 1024 * 1024)
+
+/* The average distance between end indices. */
+#define END_INDEX_SPACING 1000
+
+
+/* Returns the next pseudo-random number. */
+static uint64_t next_random(uint64_t *state) {
+  *state = (*state * 6364136223846793005ULL) + 1442695040888963407ULL;
+  return *state >> 16;
+}
+
+
+/* The binary search that crackalack_lookup used before the search tree, on a table in
+ * its file format (interleaved start and end indices). */
+static unsigned int recursive_binary_search(uint64_t *rainbow_table, unsigned int low, unsigned int high, uint64_t search_index, uint64_t *start) {
+  unsigned int chain = 0;
+
+
+  if (high - low <= 8) {
+    for (chain = low; chain < high; chain++) {
+      if (search_index == rainbow_table[(chain * 2) + 1]) {
+	*start = rainbow_table[chain * 2];
+	return 1;
+      }
+    }
+  } else {
+    chain = ((high - low) / 2) + low;
+    if (search_index >= rainbow_table[(chain * 2) + 1])
+      return recursive_binary_search(rainbow_table, chain, high, search_index, start);
+    else
+      return recursive_binary_search(rainbow_table, low, chain, search_index, start);
+  }
+
+  return 0;
+}
+
+
+static void print_result(char *method, char *simd_level_name, unsigned int num_queries, unsigned int num_found, double seconds) {
+  char description[64] = {0};
+
+
+  snprintf(description, sizeof(description), "%s (%s):", method, simd_level_name);
+  printf("  %-36s %8.2f million queries/sec  (%u found)\n", description, (num_queries / seconds) / 1000000.0, num_found);
+}
+
+
+int main(int ac, char **av) {
+  uint64_t *rainbow_table = NULL, *rainbow_table_copy = NULL, *queries = NULL;
+  uint64_t end_index = 0, start = 0, random_state = 1;
+  unsigned int num_chains = DEFAULT_NUM_CHAINS, num_queries = DEFAULT_NUM_QUERIES, i = 0, num_found = 0, *positions = NULL, level = 0;
+  struct timespec start_time = {0};
+  rt_search_table rst;
+
+
+  if (ac > 3) {
+    fprintf(stderr, "Usage: %s [num_chains [num_queries]]\n\nDefaults: %u chains, %u queries.\n\n", av[0], DEFAULT_NUM_CHAINS, DEFAULT_NUM_QUERIES);
+    return -1;
+  }
+
+  if (ac > 1)
+    num_chains = strtoul(av[1], NULL, 10);
+  if (ac > 2)
+    num_queries = strtoul(av[2], NULL, 10);
+
+  if ((num_chains == 0) || (num_queries == 0)) {
+    fprintf(stderr, "Error: the number of chains and queries must be greater than zero.\n");
+    return -1;
+  }
+
+  rainbow_table = calloc((size_t)num_chains * 2, sizeof(uint64_t));
+  rainbow_table_copy = calloc((size_t)num_chains * 2, sizeof(uint64_t));
+  queries = calloc(num_queries, sizeof(uint64_t));
+  positions = calloc(num_queries, sizeof(unsigned int));
+  if ((rainbow_table == NULL) || (rainbow_table_copy == NULL) || (queries == NULL) || (positions == NULL)) {
+    fprintf(stderr, "Failed to allocate buffers.\n");
+    return -1;
+  }
+
+  /* The end indices are spread roughly uniformly, like those of a real table. */
+  for (i = 0; i < num_chains; i++) {
+    end_index += 1 + (next_random(&random_state) % (END_INDEX_SPACING * 2));
+    rainbow_table[i * 2] = rainbow_table_copy[i * 2] = i;
+    rainbow_table[(i * 2) + 1] = rainbow_table_copy[(i * 2) + 1] = end_index;
+  }
+
+  /* Half the queries are found in the table, and half are random. */
+  for (i = 0; i < num_queries; i++) {
+    if (i & 1)
+      queries[i] = rainbow_table[((next_random(&random_state) % num_chains) * 2) + 1];
+    else
+      queries[i] = next_random(&random_state) % (end_index + 1);
+  }
+
+  printf("Searching %u chains for %u end indices...\n", num_chains, num_queries);
+
+  start_timer(&start_time);
+  for (i = 0, num_found = 0; i < num_queries; i++)
+    num_found += recursive_binary_search(rainbow_table, 0, num_chains, queries[i], &start);
+  print_result("Recursive binary search", "scalar", num_queries, num_found, get_elapsed(&start_time));
+
+  start_timer(&start_time);
+  rt_search_table_init(&rst, rainbow_table_copy, num_chains);
+  printf("  (Search tree built in %.2f seconds.)\n", get_elapsed(&start_time));
+
+  for (level = SIMD_SCALAR; level <= get_simd_level_supported(); level++) {
+    set_simd_level(level);
+
+    start_timer(&start_time);
+    for (i = 0, num_found = 0; i < num_queries; i++)
+      num_found += rt_search_table_find(&rst, queries[i], &start);
+    print_result("Search tree", get_simd_level_name(level), num_queries, num_found, get_elapsed(&start_time));
+
+    start_timer(&start_time);
+    rt_search_table_lower_bound_many(&rst, queries, num_queries, positions);
+    for (i = 0, num_found = 0; i < num_queries; i++)
+      num_found += (positions[i] < num_chains) && (rst.end_indices[positions[i]] == queries[i]);
+    print_result("Batched search tree", get_simd_level_name(level), num_queries, num_found, get_elapsed(&start_time));
+  }
+
+  rt_search_table_free(&rst);
+  free(rainbow_table);
+  free(queries);
+  free(positions);
+  return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * Rainbow Crackalack: cpu_features.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cpu_features.h"
+
+
+/* The SIMD level currently in use.  Set to -1 until the CPU is first queried. */
+static int simd_level = -1;
+
+
+/* Returns the widest SIMD level that this CPU (and build) supports. */
+unsigned int get_simd_level_supported() {
+#ifdef CPU_SIMD_SUPPORTED
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return SIMD_AVX512;
+  else if (__builtin_cpu_supports("avx2"))
+    return SIMD_AVX2;
+#endif
+  return SIMD_SCALAR;
+}
+
+
+/* Returns the SIMD level that the batched CPU functions should use. */
+unsigned int get_simd_level() {
+  if (simd_level < 0)
+    simd_level = get_simd_level_supported();
+
+  return simd_level;
+}
+
+
+/* Returns the number of 32-bit lanes processed in parallel at the given SIMD level. */
+unsigned int get_simd_lanes(unsigned int level) {
+  if (level == SIMD_AVX512)
+    return 16;
+  else if (level == SIMD_AVX2)
+    return 8;
+  else
+    return 1;
+}
+
+
+/* Returns the name of the given SIMD level. */
+char *get_simd_level_name(unsigned int level) {
+  if (level == SIMD_AVX512)
+    return "AVX-512";
+  else if (level == SIMD_AVX2)
+    return "AVX2";
+  else
+    return "scalar";
+}
+
+
+/* Overrides the SIMD level to use (i.e.: for testing the narrower code paths).  The
+ * level is clamped to what the CPU actually supports. */
+void set_simd_level(unsigned int level) {
+  unsigned int supported = get_simd_level_supported();
+
+
+  if (level > supported)
+    level = supported;
+
+  simd_level = level;
+}
@@ -0,0 +1,26 @@
+#ifndef _CPU_FEATURES_H
+#define _CPU_FEATURES_H
+
+/* The multi-buffer SIMD code paths are only compiled on x86 with GCC-compatible
+ * compilers.  MinGW's GCC does not realign the stack for 32- and 64-byte vector
+ * spills, so Windows builds stick to the scalar code. */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(_WIN32)
+#define CPU_SIMD_SUPPORTED 1
+#endif
+
+/* SIMD levels, in increasing order of width. */
+#define SIMD_SCALAR 0
+#define SIMD_AVX2   1
+#define SIMD_AVX512 2
+
+/* The maximum number of lanes any SIMD level processes at once. */
+#define SIMD_MAX_LANES 16
+
+
+unsigned int get_simd_level();
+unsigned int get_simd_lanes(unsigned int simd_level);
+unsigned int get_simd_level_supported();
+char *get_simd_level_name(unsigned int simd_level);
+void set_simd_level(unsigned int simd_level);
+
+#endif
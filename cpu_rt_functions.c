@@ -16,7 +16,18 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "charset.h"
+#include "cpu_features.h"
 #include "cpu_rt_functions.h"
+#include "des_bs.h"
+#include "fast_div.h"
+#include "hash_provider.h"
+#include "md4_simd.h"
+#include "md5.h"
+#include "sha1.h"
 #include "shared.h"
 
 
@@ -37,7 +48,8 @@ uint64_t fill_plaintext_space_table(unsigned int charset_len, unsigned int plain
 }
 
 
-uint64_t hash_to_index(unsigned char *hash_value, unsigned int hash_len, unsigned int reduction_offset, uint64_t plaintext_space_total, unsigned int pos) {
+/* Returns the first 8 bytes of a hash as a little-endian integer. */
+static inline uint64_t hash_to_uint64(unsigned char *hash_value) {
   uint64_t ret = hash_value[7];
   ret <<= 8;
   ret |= hash_value[6];
@@ -54,7 +66,12 @@ uint64_t hash_to_index(unsigned char *hash_value, unsigned int hash_len, unsigne
   ret <<= 8;
   ret |= hash_value[0];
 
-  return (ret + reduction_offset + pos) % plaintext_space_total;
+  return ret;
+}
+
+
+uint64_t hash_to_index(unsigned char *hash_value, unsigned int hash_len, unsigned int reduction_offset, uint64_t plaintext_space_total, unsigned int pos) {
+  return (hash_to_uint64(hash_value) + reduction_offset + pos) % plaintext_space_total;
 }
 
 
@@ -83,6 +100,253 @@ void index_to_plaintext(uint64_t index, char *charset, unsigned int charset_len,
 }
 
 
+/* Equivalent to hash_to_index(), but with the modulus done by multiplication with the
+ * pre-computed reciprocal of the plaintext space total. */
+uint64_t hash_to_index_fast_div(unsigned char *hash_value, unsigned int reduction_offset, const fast_div *plaintext_space_total_div, unsigned int pos) {
+  return fast_div_remainder(hash_to_uint64(hash_value) + reduction_offset + pos, plaintext_space_total_div);
+}
+
+
+/* Equivalent to index_to_plaintext(), but with the divisions by the charset length done
+ * by multiplication with its pre-computed reciprocal. */
+void index_to_plaintext_fast_div(uint64_t index, char *charset, const fast_div *charset_len_div, unsigned int plaintext_len_min, unsigned int plaintext_len_max, uint64_t *plaintext_space_up_to_index, char *plaintext, unsigned int *plaintext_len) {
+  int i;
+  uint64_t index_x, quotient;
+
+
+  for (i = plaintext_len_max - 1; i >= plaintext_len_min - 1; i--) {
+    if (index >= plaintext_space_up_to_index[i]) {
+      *plaintext_len = i + 1;
+      if (*plaintext_len >= MAX_PLAINTEXT_LEN)
+	return;
+
+      plaintext[*plaintext_len] = '\0';
+      break;
+    }
+  }
+
+  index_x = index - plaintext_space_up_to_index[*plaintext_len - 1];
+  for (i = *plaintext_len - 1; i >= 0; i--) {
+    quotient = fast_div_quotient(index_x, charset_len_div);
+    plaintext[i] = charset[index_x - (quotient * charset_len_div->divisor)];
+    index_x = quotient;
+  }
+
+  return;
+}
+
+
+/* The following reduce_*() functions split an index into its high and low base-95
+ * digits using multiplication by a reciprocal instead of division.  They are ports of
+ * the functions in CL/redux_functions_mul32.cl; see that file for the derivation of
+ * the constants.  Unlike on the GPU, the final correction is done without a branch,
+ * since the branch is taken at random and would be mispredicted half the time. */
+
+/* 9 chars -> 4 chars, 5 chars. */
+static inline void reduce_9chars(uint64_t index, uint32_t *hi4, uint64_t *lo5) {
+  uint32_t tmp = (uint32_t)(((uint64_t)((uint32_t)(index >> 32)) * 148998437) >> 28);
+  uint64_t tmp2 = index - ((uint64_t)3442842079 * tmp) - ((uint64_t)tmp << 32);
+  uint64_t adj = 0;
+
+
+  adj = (tmp2 >= 7737809375UL);
+  tmp2 -= adj * 7737809375UL;
+  tmp += adj;
+  *hi4 = tmp;
+  *lo5 = tmp2;
+}
+
+/* 8 chars -> 4 chars, 4 chars. */
+static inline void reduce_8chars(uint64_t index, uint32_t *hi4, uint32_t *lo4) {
+  uint32_t tmp = (uint32_t)(((uint64_t)((uint32_t)(index >> 25)) * 110584777) >> 28);
+  uint32_t tmp2 = (uint32_t)index - (81450625 * tmp);
+  uint32_t adj = 0;
+
+
+  adj = (tmp2 >= 81450625);
+  tmp2 -= adj * 81450625;
+  tmp += adj;
+  *hi4 = tmp;
+  *lo4 = tmp2;
+}
+
+/* 5 chars -> 2 chars, 3 chars. */
+static inline void reduce_5chars(uint64_t index, uint32_t *hi2, uint32_t *lo3) {
+  uint32_t tmp = (uint32_t)(((index >> 18) * 20037) >> 16);
+  uint32_t tmp2 = (uint32_t)index - (857375 * tmp);
+  uint32_t adj = 0;
+
+
+  adj = (tmp2 >= 857375);
+  tmp2 -= adj * 857375;
+  tmp += adj;
+  *hi2 = tmp;
+  *lo3 = tmp2;
+}
+
+/* 4 chars -> 2 chars, 2 chars. */
+static inline void reduce_4chars(uint32_t index, uint32_t *hi2, uint32_t *lo2) {
+  uint32_t tmp = ((index >> 12) * 14871) >> 15;
+  uint32_t tmp2 = index - (9025 * tmp);
+  uint32_t adj = 0;
+
+
+  adj = (tmp2 >= 9025);
+  tmp2 -= adj * 9025;
+  tmp += adj;
+  *hi2 = tmp;
+  *lo2 = tmp2;
+}
+
+/* 3 chars -> 1 char, 2 chars. */
+static inline void reduce_3chars(uint32_t index, char *hi1, uint32_t *lo2) {
+  uint32_t tmp = ((index >> 13) * 116) >> 7;
+  uint32_t tmp2 = index - (9025 * tmp);
+  uint32_t adj = 0;
+
+
+  adj = (tmp2 >= 9025);
+  tmp2 -= adj * 9025;
+  tmp += adj;
+  *hi1 = tmp + 32;
+  *lo2 = tmp2;
+}
+
+/* 2 chars -> 1 char, 1 char. */
+static inline void reduce_2chars(uint32_t index, char *hi1, char *lo1) {
+  uint32_t tmp = ((index >> 6) * 172) >> 8;
+  uint32_t tmp2 = index - (95 * tmp);
+  uint32_t adj = 0;
+
+
+  adj = (tmp2 >= 95);
+  tmp2 -= adj * 95;
+  tmp += adj;
+  *hi1 = tmp + 32;
+  *lo1 = tmp2 + 32;
+}
+
+
+/* Returns the plaintext length if the parameters allow the specialized NTLM8 or NTLM9
+ * functions, below, to be used (NTLM hashes, the ascii-32-95 charset, and a fixed
+ * length of 8 or 9 characters).  Otherwise, returns 0. */
+unsigned int ntlm_fixed_len(unsigned int hash_type, char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max) {
+  if ((hash_type == HASH_NTLM) && \
+      (plaintext_len_min == plaintext_len_max) && \
+      ((plaintext_len_min == 8) || (plaintext_len_min == 9)) && \
+      (strcmp(charset, CHARSET_ASCII_32_95) == 0))
+    return plaintext_len_min;
+  else
+    return 0;
+}
+
+
+/* Equivalent to hash_to_index() with a plaintext space of 95^8.  Since the modulus
+ * is a constant, the compiler replaces the division with a multiplication. */
+uint64_t hash_to_index_ntlm8(unsigned char *hash_value, unsigned int reduction_offset, unsigned int pos) {
+  return (hash_to_uint64(hash_value) + reduction_offset + pos) % NTLM8_PLAINTEXT_SPACE_TOTAL;
+}
+
+
+/* Equivalent to hash_to_index() with a plaintext space of 95^9.  Port of
+ * hash_to_index_ntlm9() in CL/ntlm9_functions.cl. */
+uint64_t hash_to_index_ntlm9(unsigned char *hash_value, unsigned int reduction_offset, unsigned int pos) {
+  uint64_t ret = hash_to_uint64(hash_value) + reduction_offset + pos;
+  uint32_t tmp = 0;
+
+
+  /* floor(2 * 2**64 / 95**9) = 58 */
+  tmp = ((ret >> 58) * 29) >> 6;
+
+  ret -= NTLM9_PLAINTEXT_SPACE_TOTAL * tmp;
+  if (ret >= NTLM9_PLAINTEXT_SPACE_TOTAL)
+    ret -= NTLM9_PLAINTEXT_SPACE_TOTAL;
+
+  return ret;
+}
+
+
+/* Equivalent to index_to_plaintext() with the ascii-32-95 charset and a fixed length
+ * of 8.  The plaintext buffer must hold at least 9 bytes. */
+void index_to_plaintext_ntlm8(uint64_t index, char *plaintext) {
+  uint32_t hi4 = 0, lo4 = 0, hi2 = 0, lo2 = 0;
+
+
+  reduce_8chars(index, &hi4, &lo4);
+  reduce_4chars(hi4, &hi2, &lo2);
+  reduce_2chars(hi2, plaintext + 0, plaintext + 1);
+  reduce_2chars(lo2, plaintext + 2, plaintext + 3);
+  reduce_4chars(lo4, &hi2, &lo2);
+  reduce_2chars(hi2, plaintext + 4, plaintext + 5);
+  reduce_2chars(lo2, plaintext + 6, plaintext + 7);
+  plaintext[8] = '\0';
+}
+
+
+/* Equivalent to index_to_plaintext() with the ascii-32-95 charset and a fixed length
+ * of 9.  The plaintext buffer must hold at least 10 bytes.  Port of
+ * index_to_plaintext_ntlm9() in CL/ntlm9_functions.cl. */
+void index_to_plaintext_ntlm9(uint64_t index, char *plaintext) {
+  uint64_t lo5 = 0;
+  uint32_t hi4 = 0, lo3 = 0, hi2 = 0, lo2 = 0;
+
+
+  reduce_9chars(index, &hi4, &lo5);
+  reduce_4chars(hi4, &hi2, &lo2);
+  reduce_2chars(hi2, plaintext + 0, plaintext + 1);
+  reduce_2chars(lo2, plaintext + 2, plaintext + 3);
+  reduce_5chars(lo5, &hi2, &lo3);
+  reduce_2chars(hi2, plaintext + 4, plaintext + 5);
+  reduce_3chars(lo3, plaintext + 6, &lo2);
+  reduce_2chars(lo2, plaintext + 7, plaintext + 8);
+  plaintext[9] = '\0';
+}
+
+
+/* Fills in a reduction context for the specified table parameters.  The hash provider
+ * is looked up, and the specialized NTLM8/NTLM9 functions are selected when possible;
+ * otherwise, the reciprocals of the charset length and plaintext space total are
+ * computed for the generic functions.  Terminates if the hash type has no CPU
+ * implementation. */
+void init_reduction_context(reduction_context *rc, unsigned int hash_type, char *charset, unsigned int charset_len, unsigned int plaintext_len_min, unsigned int plaintext_len_max, uint64_t plaintext_space_total) {
+  rc->hp = get_hash_provider(hash_type);
+  if (rc->hp == NULL) {
+    fprintf(stderr, "Error: hash type %u has no CPU implementation.\n", hash_type);
+    exit(-1);
+  }
+
+  rc->fixed_len = ntlm_fixed_len(hash_type, charset, plaintext_len_min, plaintext_len_max);
+  fast_div_init(&(rc->charset_len_div), charset_len);
+  fast_div_init(&(rc->plaintext_space_total_div), plaintext_space_total);
+}
+
+
+/* Performs the index-to-plaintext step of a chain, using the fastest function that the
+ * reduction context allows. */
+void step_index_to_plaintext(const reduction_context *rc, uint64_t index, char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max, uint64_t *plaintext_space_up_to_index, char *plaintext, unsigned int *plaintext_len) {
+  if (rc->fixed_len == 8) {
+    index_to_plaintext_ntlm8(index, plaintext);
+    *plaintext_len = 8;
+  } else if (rc->fixed_len == 9) {
+    index_to_plaintext_ntlm9(index, plaintext);
+    *plaintext_len = 9;
+  } else
+    index_to_plaintext_fast_div(index, charset, &(rc->charset_len_div), plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, plaintext_len);
+}
+
+
+/* Performs the hash-to-index step of a chain, using the fastest function that the
+ * reduction context allows. */
+uint64_t step_hash_to_index(const reduction_context *rc, unsigned char *hash_value, unsigned int reduction_offset, unsigned int pos) {
+  if (rc->fixed_len == 8)
+    return hash_to_index_ntlm8(hash_value, reduction_offset, pos);
+  else if (rc->fixed_len == 9)
+    return hash_to_index_ntlm9(hash_value, reduction_offset, pos);
+  else
+    return rc->hp->hash_to_index(hash_value, reduction_offset, &(rc->plaintext_space_total_div), pos);
+}
+
+
 uint64_t generate_rainbow_chain(
     unsigned int hash_type,
     char *charset,
@@ -98,27 +362,72 @@ uint64_t generate_rainbow_chain(
     unsigned int *plaintext_len,
     unsigned char *hash,
     unsigned int *hash_len) {
+  reduction_context rc;
   uint64_t index = start;
   unsigned int pos = 0;
 
 
-  if (hash_type != HASH_NTLM)
-    fprintf(stderr, "\n\tWARNING: only NTLM hashes are currently supported!\n\n");
-
+  init_reduction_context(&rc, hash_type, charset, charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_total);
+  *hash_len = rc.hp->hash_len;
   for (; pos < chain_len - 1; pos++) {
-    index_to_plaintext(index, charset, charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, plaintext_len);
-    ntlm_hash(plaintext, *plaintext_len, hash);
-    index = hash_to_index(hash, *hash_len, reduction_offset, plaintext_space_total, pos);
+    step_index_to_plaintext(&rc, index, charset, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintext, plaintext_len);
+    rc.hp->hash(plaintext, *plaintext_len, hash);
+    index = step_hash_to_index(&rc, hash, reduction_offset, pos);
   }
   return index;
 }
 
 
-/* Calculates the NTLM hash on the specified plaintext.  The result is stored in the hash
- * argument, which must be at least 16 bytes in size. */
-void ntlm_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash) {
-  unsigned int key[16] = {0};
-  unsigned int output[4];
+/* Advances many chains at once, in the same manner as the crackalack kernel: each
+ * entry in indices is taken to be the index at position pos_start, and is replaced with
+ * the chain's end index (i.e.: the index after position chain_len - 2).  The chains are
+ * walked in lockstep so that the hashing can be done in SIMD lanes.  The results are
+ * identical to calling generate_rainbow_chain() on each index when pos_start is 0. */
+void generate_rainbow_chains(
+    unsigned int hash_type,
+    char *charset,
+    unsigned int charset_len,
+    unsigned int plaintext_len_min,
+    unsigned int plaintext_len_max,
+    unsigned int reduction_offset,
+    unsigned int pos_start,
+    unsigned int chain_len,
+    uint64_t *indices,
+    unsigned int num_indices,
+    uint64_t *plaintext_space_up_to_index,
+    uint64_t plaintext_space_total) {
+  char plaintexts[CHAIN_BATCH_SIZE * MAX_PLAINTEXT_LEN];
+  unsigned char hashes[CHAIN_BATCH_SIZE * MAX_HASH_OUTPUT_LEN];
+  unsigned int plaintext_lens[CHAIN_BATCH_SIZE];
+  unsigned int batch_start = 0, batch_len = 0, pos = 0, i = 0;
+  uint64_t *batch = NULL;
+  reduction_context rc;
+
+
+  init_reduction_context(&rc, hash_type, charset, charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_total);
+
+  for (batch_start = 0; batch_start < num_indices; batch_start += CHAIN_BATCH_SIZE) {
+    batch = indices + batch_start;
+    batch_len = num_indices - batch_start;
+    if (batch_len > CHAIN_BATCH_SIZE)
+      batch_len = CHAIN_BATCH_SIZE;
+
+    for (pos = pos_start; pos < chain_len - 1; pos++) {
+      for (i = 0; i < batch_len; i++)
+	step_index_to_plaintext(&rc, batch[i], charset, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, plaintexts + (i * MAX_PLAINTEXT_LEN), &(plaintext_lens[i]));
+
+      rc.hp->hash_many(plaintexts, plaintext_lens, batch_len, hashes);
+
+      for (i = 0; i < batch_len; i++)
+	batch[i] = step_hash_to_index(&rc, hashes + (i * MAX_HASH_OUTPUT_LEN), reduction_offset, pos);
+    }
+  }
+}
+
+
+/* Fills in the single MD4 block for the NTLM hash of the specified plaintext.  Word i
+ * of the block is stored in key[i * stride], and all 16 words must already be zero. */
+static void ntlm_key(char *plaintext, unsigned int plaintext_len, unsigned int *key, unsigned int stride) {
   int i = 0;
 
 
@@ -128,15 +437,26 @@ void ntlm_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash)
   }
 
   for (; i < (plaintext_len / 2); i++)
-    key[i] = plaintext[i * 2] | (plaintext[(i * 2) + 1] << 16);
+    key[i * stride] = plaintext[i * 2] | (plaintext[(i * 2) + 1] << 16);
 
   if ((plaintext_len % 2) == 1)
-    key[i] = plaintext[plaintext_len - 1] | 0x800000;
+    key[i * stride] = plaintext[plaintext_len - 1] | 0x800000;
   else
-    key[i] = 0x80;
+    key[i * stride] = 0x80;
+
+  key[14 * stride] = plaintext_len << 4;
+}
+
+
+/* Calculates the NTLM hash on the specified plaintext.  The result is stored in the hash
+ * argument, which must be at least 16 bytes in size. */
+void ntlm_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash) {
+  unsigned int key[16] = {0};
+  unsigned int output[4];
+  int i = 0;
 
-  key[14] = plaintext_len << 4;
 
+  ntlm_key(plaintext, plaintext_len, key, 1);
   md4_encrypt(output, key);
 
   i = 0;
@@ -159,6 +479,192 @@ void ntlm_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash)
 }
 
 
+/* Stores num_words digest words, each stride words apart, into hash as little-endian
+ * (MD4, MD5) or big-endian (SHA-1) bytes. */
+static inline void store_digest(unsigned int *words, unsigned int stride, unsigned int num_words, unsigned int big_endian, unsigned char *hash) {
+  unsigned int i = 0, word = 0;
+
+
+  for (i = 0; i < num_words; i++) {
+    word = words[i * stride];
+    if (big_endian) {
+      hash[(i * 4) + 0] = ((word >> 24) & 0xff);
+      hash[(i * 4) + 1] = ((word >> 16) & 0xff);
+      hash[(i * 4) + 2] = ((word >> 8) & 0xff);
+      hash[(i * 4) + 3] = ((word >> 0) & 0xff);
+    } else {
+      hash[(i * 4) + 0] = ((word >> 0) & 0xff);
+      hash[(i * 4) + 1] = ((word >> 8) & 0xff);
+      hash[(i * 4) + 2] = ((word >> 16) & 0xff);
+      hash[(i * 4) + 3] = ((word >> 24) & 0xff);
+    }
+  }
+}
+
+
+#ifdef CPU_SIMD_SUPPORTED
+/* Hashes num_plaintexts plaintexts with a single-block hash function, 16 (AVX-512) or 8
+ * (AVX2) at a time.  The key function fills in the block for one plaintext, and
+ * encrypt_x8/encrypt_x16 are the multi-buffer compression functions. */
+static void simd_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes, unsigned int simd_level, void (*key)(char *, unsigned int, unsigned int *, unsigned int), void (*encrypt_x8)(unsigned int *, unsigned int *), void (*encrypt_x16)(unsigned int *, unsigned int *), unsigned int num_words, unsigned int big_endian) {
+  unsigned int W[16 * SIMD_MAX_LANES], output[5 * SIMD_MAX_LANES];
+  unsigned int lanes = get_simd_lanes(simd_level), num_lanes = 0, lane = 0, i = 0;
+
+
+  for (i = 0; i < num_plaintexts; i += lanes) {
+    num_lanes = num_plaintexts - i;
+    if (num_lanes > lanes)
+      num_lanes = lanes;
+
+    /* Transpose the keys so that each word is contiguous across lanes.  Unused lanes
+     * are hashed too, but their results are discarded. */
+    memset(W, 0, 16 * lanes * sizeof(unsigned int));
+    for (lane = 0; lane < num_lanes; lane++)
+      key(plaintexts + ((i + lane) * MAX_PLAINTEXT_LEN), plaintext_lens[i + lane], W + lane, lanes);
+
+    if (simd_level == SIMD_AVX512)
+      encrypt_x16(output, W);
+    else
+      encrypt_x8(output, W);
+
+    for (lane = 0; lane < num_lanes; lane++)
+      store_digest(output + lane, lanes, num_words, big_endian, hashes + ((i + lane) * MAX_HASH_OUTPUT_LEN));
+  }
+}
+#endif
+
+
+/* Calculates the NTLM hashes of num_plaintexts plaintexts at once.  Plaintext i is
+ * read from &plaintexts[i * MAX_PLAINTEXT_LEN] with length plaintext_lens[i], and its
+ * hash is written to &hashes[i * MAX_HASH_OUTPUT_LEN].  Depending on the CPU, 16
+ * (AVX-512), 8 (AVX2), or 1 (scalar) plaintexts are hashed in parallel; the results
+ * are identical to calling ntlm_hash() on each plaintext. */
+void ntlm_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes) {
+  unsigned int i = 0;
+
+
+#ifdef CPU_SIMD_SUPPORTED
+  if (get_simd_level() != SIMD_SCALAR) {
+    simd_hash_many(plaintexts, plaintext_lens, num_plaintexts, hashes, get_simd_level(), ntlm_key, md4_encrypt_x8, md4_encrypt_x16, 4, 0);
+    return;
+  }
+#endif
+
+  for (i = 0; i < num_plaintexts; i++)
+    ntlm_hash(plaintexts + (i * MAX_PLAINTEXT_LEN), plaintext_lens[i], hashes + (i * MAX_HASH_OUTPUT_LEN));
+}
+
+
+/* Fills in the single MD5 block of the specified plaintext.  Word i of the block is
+ * stored in key[i * stride], and all 16 words must already be zero.  SHA-1 blocks are
+ * the same, except that the words and the length are big-endian. */
+static void md5_sha1_key(char *plaintext, unsigned int plaintext_len, unsigned int *key, unsigned int stride, unsigned int big_endian) {
+  unsigned int i = 0, shift = 0;
+
+
+  if (plaintext_len > 55) {
+    plaintext[55] = 0;
+    plaintext_len = 55;
+  }
+
+  for (i = 0; i <= plaintext_len; i++) {
+    shift = big_endian ? (24 - ((i % 4) * 8)) : ((i % 4) * 8);
+    key[(i / 4) * stride] |= (unsigned int)((i < plaintext_len) ? (unsigned char)plaintext[i] : 0x80) << shift;
+  }
+
+  key[(big_endian ? 15 : 14) * stride] = plaintext_len << 3;
+}
+
+
+static void md5_key(char *plaintext, unsigned int plaintext_len, unsigned int *key, unsigned int stride) {
+  md5_sha1_key(plaintext, plaintext_len, key, stride, 0);
+}
+
+
+static void sha1_key(char *plaintext, unsigned int plaintext_len, unsigned int *key, unsigned int stride) {
+  md5_sha1_key(plaintext, plaintext_len, key, stride, 1);
+}
+
+
+/* Calculates the MD5 hash on the specified plaintext.  The result is stored in the hash
+ * argument, which must be at least 16 bytes in size. */
+void md5_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash) {
+  unsigned int key[16] = {0};
+  unsigned int output[4];
+
+
+  md5_key(plaintext, plaintext_len, key, 1);
+  md5_encrypt(output, key);
+  store_digest(output, 1, 4, 0, hash);
+}
+
+
+/* Calculates the MD5 hashes of num_plaintexts plaintexts at once, in the same manner as
+ * ntlm_hash_many(). */
+void md5_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes) {
+  unsigned int i = 0;
+
+
+#ifdef CPU_SIMD_SUPPORTED
+  if (get_simd_level() != SIMD_SCALAR) {
+    simd_hash_many(plaintexts, plaintext_lens, num_plaintexts, hashes, get_simd_level(), md5_key, md5_encrypt_x8, md5_encrypt_x16, 4, 0);
+    return;
+  }
+#endif
+
+  for (i = 0; i < num_plaintexts; i++)
+    md5_hash(plaintexts + (i * MAX_PLAINTEXT_LEN), plaintext_lens[i], hashes + (i * MAX_HASH_OUTPUT_LEN));
+}
+
+
+/* Calculates the SHA-1 hash on the specified plaintext.  The result is stored in the
+ * hash argument, which must be at least 20 bytes in size. */
+void sha1_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash) {
+  unsigned int key[16] = {0};
+  unsigned int output[5];
+
+
+  sha1_key(plaintext, plaintext_len, key, 1);
+  sha1_encrypt(output, key);
+  store_digest(output, 1, 5, 1, hash);
+}
+
+
+/* Calculates the SHA-1 hashes of num_plaintexts plaintexts at once, in the same manner
+ * as ntlm_hash_many(). */
+void sha1_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes) {
+  unsigned int i = 0;
+
+
+#ifdef CPU_SIMD_SUPPORTED
+  if (get_simd_level() != SIMD_SCALAR) {
+    simd_hash_many(plaintexts, plaintext_lens, num_plaintexts, hashes, get_simd_level(), sha1_key, sha1_encrypt_x8, sha1_encrypt_x16, 5, 1);
+    return;
+  }
+#endif
+
+  for (i = 0; i < num_plaintexts; i++)
+    sha1_hash(plaintexts + (i * MAX_PLAINTEXT_LEN), plaintext_lens[i], hashes + (i * MAX_HASH_OUTPUT_LEN));
+}
+
+
+/* Calculates the LM hash on the specified plaintext (of up to 7 characters).  The
+ * result is stored in the hash argument, which must be at least 8 bytes in size.  This
+ * runs the 64-lane bitsliced DES with a single lane in use, so prefer lm_hash_many()
+ * wherever more than one plaintext is available. */
+void lm_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash) {
+  des_bs_lm_hash_many(plaintext, &plaintext_len, 1, hash, SIMD_SCALAR);
+}
+
+
+/* Calculates the LM hashes of num_plaintexts plaintexts at once, in the same manner as
+ * ntlm_hash_many().  Depending on the CPU, up to 512 (AVX-512), 256 (AVX2), or 64
+ * plaintexts are hashed in parallel by the bitsliced DES. */
+void lm_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes) {
+  des_bs_lm_hash_many(plaintexts, plaintext_lens, num_plaintexts, hashes, get_simd_level());
+}
+
+
 /* The below copyright notice applies to the md4_encrypt() function only. */
 
 /*
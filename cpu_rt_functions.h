@@ -3,6 +3,22 @@
 
 #include <stdint.h>
 
+#include "fast_div.h"
+#include "hash_provider.h"
+
+/* The number of chains that generate_rainbow_chains() advances in lockstep.  This is a
+ * multiple of every SIMD width, including the 512 lanes of the bitsliced DES. */
+#define CHAIN_BATCH_SIZE 512
+
+/* Pre-computed state for the reduction steps of a table (see init_reduction_context()). */
+struct _reduction_context {
+  const hash_provider *hp;
+  unsigned int fixed_len;  /* 8 or 9 when the NTLM8/NTLM9 functions apply, else 0. */
+  fast_div charset_len_div;
+  fast_div plaintext_space_total_div;
+};
+typedef struct _reduction_context reduction_context;
+
 
 uint64_t fill_plaintext_space_table(unsigned int charset_len, unsigned int plaintext_len_min, unsigned int plaintext_len_max, uint64_t *plaintext_space_up_to_index);
 
@@ -10,10 +26,46 @@ uint64_t hash_to_index(unsigned char *hash_value, unsigned int hash_len, unsigne
 
 void index_to_plaintext(uint64_t index, char *charset, unsigned int charset_len, unsigned int plaintext_len_min, unsigned int plaintext_len_max, uint64_t *plaintext_space_up_to_index, char *plaintext, unsigned int *plaintext_len);
 
+uint64_t hash_to_index_fast_div(unsigned char *hash_value, unsigned int reduction_offset, const fast_div *plaintext_space_total_div, unsigned int pos);
+
+void index_to_plaintext_fast_div(uint64_t index, char *charset, const fast_div *charset_len_div, unsigned int plaintext_len_min, unsigned int plaintext_len_max, uint64_t *plaintext_space_up_to_index, char *plaintext, unsigned int *plaintext_len);
+
+unsigned int ntlm_fixed_len(unsigned int hash_type, char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max);
+
+uint64_t hash_to_index_ntlm8(unsigned char *hash_value, unsigned int reduction_offset, unsigned int pos);
+
+uint64_t hash_to_index_ntlm9(unsigned char *hash_value, unsigned int reduction_offset, unsigned int pos);
+
+void index_to_plaintext_ntlm8(uint64_t index, char *plaintext);
+
+void index_to_plaintext_ntlm9(uint64_t index, char *plaintext);
+
+void init_reduction_context(reduction_context *rc, unsigned int hash_type, char *charset, unsigned int charset_len, unsigned int plaintext_len_min, unsigned int plaintext_len_max, uint64_t plaintext_space_total);
+
+void step_index_to_plaintext(const reduction_context *rc, uint64_t index, char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max, uint64_t *plaintext_space_up_to_index, char *plaintext, unsigned int *plaintext_len);
+
+uint64_t step_hash_to_index(const reduction_context *rc, unsigned char *hash_value, unsigned int reduction_offset, unsigned int pos);
+
 void ntlm_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash);
 
+void ntlm_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes);
+
+void md5_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash);
+
+void md5_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes);
+
+void sha1_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash);
+
+void sha1_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes);
+
+void lm_hash(char *plaintext, unsigned int plaintext_len, unsigned char *hash);
+
+void lm_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes);
+
 uint64_t generate_rainbow_chain(unsigned int hash_type, char *charset, unsigned int charset_len, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned int reduction_offset, unsigned int chain_len, uint64_t start, uint64_t *plaintext_space_up_to_index, uint64_t plaintext_space_total, char *plaintext, unsigned int *plaintext_len, unsigned char *hash, unsigned int *hash_len);
 
+void generate_rainbow_chains(unsigned int hash_type, char *charset, unsigned int charset_len, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned int reduction_offset, unsigned int pos_start, unsigned int chain_len, uint64_t *indices, unsigned int num_indices, uint64_t *plaintext_space_up_to_index, uint64_t plaintext_space_total);
+
 void md4_encrypt(unsigned int *hash, unsigned int *W);
 
 #endif
@@ -34,9 +34,11 @@
 
 #include "charset.h"
 #include "clock.h"
+#include "cpu_features.h"
 #include "cpu_rt_functions.h"
 #include "file_lock.h"
 #include "gws.h"
+#include "hash_provider.h"
 #include "hash_validate.h"
 #include "misc.h"
 #include "shared.h"
@@ -46,8 +48,6 @@
 
 
 #define CRACKALACK_KERNEL_PATH "crackalack.cl"
-#define CRACKALACK_NTLM8_KERNEL_PATH "crackalack_ntlm8.cl"
-#define CRACKALACK_NTLM9_KERNEL_PATH "crackalack_ntlm9.cl"
 
 #define VERBOSE 1
 
@@ -62,6 +62,9 @@
  * progress. */
 #define UPDATE_INTERVAL (1 * 60)  /* 1 minute */
 
+/* The number of chains each CPU thread takes from the start index counter at a time. */
+#define CPU_CHAINS_PER_BLOCK (CHAIN_BATCH_SIZE * 2)
+
 
 #define LOCK_START_INDEX() \
   if (pthread_mutex_lock(&start_index_mutex)) { perror("Failed to lock mutex"); exit(-1); }
@@ -80,7 +83,9 @@ struct hash_names {
 };
 struct hash_names valid_hash_names[] = {
   {"lm", HASH_LM},
-  /*{"ntlm", HASH_NTLM}*/
+  {"ntlm", HASH_NTLM},
+  {"md5", HASH_MD5},
+  {"sha1", HASH_SHA1},
 };
 
 
@@ -110,6 +115,9 @@ typedef struct {
 
   unsigned int initial_chains_per_execution;
 
+  /* The thread number, when generating with the CPU backend. */
+  unsigned int cpu_thread_number;
+
   gpu_dev gpu;
 } thread_args;
 
@@ -152,7 +160,7 @@ size_t user_provided_gws = 0;
 
 
 void print_usage_and_exit(char *prog_name, int exit_code) {
-  fprintf(stderr, "Usage: %s hash_algorithm charset_name plaintext_min_length plaintext_max_length table_index chain_length number_of_chains [part_index | -bench] [-gws GWS]\n\nExample: %s ntlm ascii-32-95 9 9 0 803000 67108864 0\n\n", prog_name, prog_name);
+  fprintf(stderr, "Usage: %s hash_algorithm charset_name plaintext_min_length plaintext_max_length table_index chain_length number_of_chains [part_index | -bench] [-gws GWS] [-cpu]\n\nExample: %s ntlm ascii-32-95 9 9 0 803000 67108864 0\n\nThe -cpu option generates chains on all CPU cores instead of on GPUs.\n\n", prog_name, prog_name);
   exit(exit_code);
 }
 
@@ -199,7 +207,7 @@ void *host_thread(void *ptr) {
   thread_args *args = (thread_args *)ptr;
   gpu_dev *gpu = &(args->gpu);
 
-  char *kernel_path = CRACKALACK_KERNEL_PATH, *kernel_name = "crackalack";
+  char *kernel_path = CRACKALACK_KERNEL_PATH, *kernel_name = "crackalack", table_build_options[1536] = {0};
   size_t gws = 0, kernel_work_group_size = 0, kernel_preferred_work_group_size_multiple = 0;
   uint64_t *start_indices = NULL, *end_indices = NULL;
   unsigned int i = 0, indices_size = 0, thread_complete = 0, num_passes = 0, pass = 0, chain_len = 0;
@@ -216,17 +224,13 @@ void *host_thread(void *ptr) {
   cl_uint pos_start = 0;
 
 
-  /* If we're generating the standard NTLM 8- or 9-character tables, use the special
-   * optimized kernel instead! */
+  /* If we're generating the standard NTLM 8- or 9-character tables, the kernel is built
+   * with the optimized functions instead (see get_table_build_options()). */
   if (is_ntlm8(args->hash_type, args->charset, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, args->chain_len)) {
-    kernel_path = CRACKALACK_NTLM8_KERNEL_PATH;
-    kernel_name = "crackalack_ntlm8";
     if (args->gpu.device_number == 0) { /* Only the first thread prints this. */
       printf("%sNote: optimized NTLM8 kernel will be used.%s\n", GREENB, CLR); fflush(stdout);
     }
   } else if (is_ntlm9(args->hash_type, args->charset, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, args->chain_len)) {
-    kernel_path = CRACKALACK_NTLM9_KERNEL_PATH;
-    kernel_name = "crackalack_ntlm9";
     if (args->gpu.device_number == 0) { /* Only the first thread prints this. */
       printf("%sNote: optimized NTLM9 kernel will be used.%s\n", GREENB, CLR); fflush(stdout);
     }
@@ -240,7 +244,8 @@ void *host_thread(void *ptr) {
   /* Load the kernel. */
   gpu->context = CLCREATECONTEXT(context_callback, &(gpu->device));
   gpu->queue = CLCREATEQUEUE(gpu->context, gpu->device);
-  load_kernel(gpu->context, 1, &(gpu->device), kernel_path, kernel_name, &(gpu->program), &(gpu->kernel), args->hash_type);
+  get_table_build_options(table_build_options, sizeof(table_build_options), args->hash_type, args->charset, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, args->chain_len);
+  load_kernel(gpu->context, 1, &(gpu->device), kernel_path, kernel_name, &(gpu->program), &(gpu->kernel), args->hash_type, table_build_options);
 
   context = gpu->context;
   queue = gpu->queue;
@@ -408,6 +413,60 @@ void *host_thread(void *ptr) {
 }
 
 
+/* A host thread which generates chains on one CPU core.  Blocks of start indices are
+ * taken from the same counter that the GPU threads use, so the output file is
+ * identical. */
+void *cpu_host_thread(void *ptr) {
+  thread_args *args = (thread_args *)ptr;
+  uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
+  uint64_t *start_indices = NULL, *end_indices = NULL;
+  uint64_t plaintext_space_total = 0;
+  unsigned int i = 0, indices_size = CPU_CHAINS_PER_BLOCK, charset_len = strlen(args->charset);
+
+
+  plaintext_space_total = fill_plaintext_space_table(charset_len, args->plaintext_len_min, args->plaintext_len_max, plaintext_space_up_to_index);
+
+  start_indices = calloc(indices_size, sizeof(uint64_t));
+  end_indices = calloc(indices_size, sizeof(uint64_t));
+  if ((start_indices == NULL) || (end_indices == NULL)) {
+    fprintf(stderr, "Failed to create start/end index buffers.\n");
+    exit(-1);
+  }
+
+  while(1) {
+    LOCK_START_INDEX();
+
+    /* Check if all chains were already created.  If so, release the mutex and
+     * terminate the thread. */
+    if ((start_index - first_generated_chain) >= num_chains_to_generate) {
+      UNLOCK_START_INDEX();
+      break;
+    }
+
+    for (i = 0; i < indices_size; i++) {
+      start_indices[i] = start_index;
+      start_index++;
+    }
+    UNLOCK_START_INDEX();
+
+    /* The end indices are computed in-place. */
+    memcpy(end_indices, start_indices, indices_size * sizeof(uint64_t));
+    generate_rainbow_chains(args->hash_type, args->charset, charset_len, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, 0, args->chain_len, end_indices, indices_size, plaintext_space_up_to_index, plaintext_space_total);
+
+    write_chains(args->filename, 1, start_indices, indices_size, end_indices, indices_size, args->cpu_thread_number);
+
+    /* Thread #0 outputs the generation progress periodically. */
+    if ((args->cpu_thread_number == 0) && (get_elapsed(&last_update_time) >= UPDATE_INTERVAL))
+      output_progress(1);
+  }
+
+  FREE(start_indices);
+  FREE(end_indices);
+  pthread_exit(NULL);
+  return NULL;
+}
+
+
 /* Writes the chains given by the kernel to the file. */
 void write_chains(char *filename, unsigned int chains_per_work_unit, cl_ulong *start_indices, unsigned int start_indices_size, cl_ulong *end_indices, unsigned int end_indices_size, unsigned int thread_id) {
   int i = 0, j = 0;
@@ -490,7 +549,7 @@ void write_chains(char *filename, unsigned int chains_per_work_unit, cl_ulong *s
 int main(int ac, char **av) {
   cl_platform_id platforms[MAX_NUM_PLATFORMS] = {0};
   cl_device_id devices[MAX_NUM_DEVICES] = {0};
-  pthread_t threads[MAX_NUM_DEVICES] = {0};
+  pthread_t *threads = NULL;
   char filename[256] = {0}, time_str[128] = {0};
 
   FILE *f = NULL;
@@ -499,6 +558,7 @@ int main(int ac, char **av) {
   char *hash_name = NULL, *charset_name = NULL, *charset = NULL;
   unsigned int plaintext_len_min = 0, plaintext_len_max = 0, total_chains_in_table = 0, table_index = 0, benchmark_mode = 0;
   unsigned int resuming_table = 0;  /* Set when a table gen is being resumed. */
+  unsigned int use_cpu = 0, num_threads = 0;
   cl_uint hash_type = 0, chain_len = 0, num_platforms = 0, num_devices = 0;
   uint64_t part_index = 0;
   int i = 0;
@@ -513,9 +573,7 @@ int main(int ac, char **av) {
   /*setenv("HSA_ENABLE_SDMA", "0", 1);*/ /* The ROCm driver on AMD Vega 64 doesn't work without this. */
 #endif
 
-  if ((ac != 9) && (ac != 11))
-    print_usage_and_exit(av[0], -1);
-  if ((ac == 11) && (strcmp(av[9], "-gws") != 0))
+  if (ac < 9)
     print_usage_and_exit(av[0], -1);
 
   /* Read command-line arguments. */
@@ -535,9 +593,15 @@ int main(int ac, char **av) {
   } else
     part_index = (unsigned int)atoi(av[8]);
 
-  /* Manually override the global work size. */
-  if (ac == 11)
-    user_provided_gws = (unsigned int)atoi(av[10]);
+  /* Parse the optional arguments. */
+  for (i = 9; i < ac; i++) {
+    if ((strcmp(av[i], "-gws") == 0) && (i + 1 < ac)) /* Manually override the global work size. */
+      user_provided_gws = (unsigned int)atoi(av[++i]);
+    else if (strcmp(av[i], "-cpu") == 0)
+      use_cpu = 1;
+    else
+      print_usage_and_exit(av[0], -1);
+  }
 
 
   /* Check that this system has sufficient RAM. */
@@ -689,27 +753,39 @@ int main(int ac, char **av) {
     }
   }
 
-  /* Get the number of platforms and devices available. */
-  get_platforms_and_devices(-1, MAX_NUM_PLATFORMS, platforms, &num_platforms, MAX_NUM_DEVICES, devices, &num_devices, VERBOSE);
+  if (use_cpu) {
+    if (get_hash_provider(hash_type) == NULL) {
+      fprintf(stderr, "Error: hash \"%s\" cannot be generated on the CPU.\n", hash_name);
+      exit(-1);
+    }
+
+    num_threads = get_num_cpu_cores();
+    printf("Generating with %u CPU threads (%s).\n\n", num_threads, get_simd_level_name(get_simd_level()));
+  } else {
+    /* Get the number of platforms and devices available. */
+    get_platforms_and_devices(-1, MAX_NUM_PLATFORMS, platforms, &num_platforms, MAX_NUM_DEVICES, devices, &num_devices, VERBOSE);
 
-  /* Check the device type and set flags.*/
-  if (num_devices > 0) {
-    char device_vendor[128] = {0};
+    /* Check the device type and set flags.*/
+    if (num_devices > 0) {
+      char device_vendor[128] = {0};
 
-    get_device_str(devices[0], CL_DEVICE_VENDOR, device_vendor, sizeof(device_vendor) - 1);
-    if (strstr(device_vendor, "Advanced Micro Devices") != NULL)
-      is_amd_gpu = 1;
+      get_device_str(devices[0], CL_DEVICE_VENDOR, device_vendor, sizeof(device_vendor) - 1);
+      if (strstr(device_vendor, "Advanced Micro Devices") != NULL)
+	is_amd_gpu = 1;
+    }
+    num_threads = num_devices;
   }
 
   /* Initialize the barrier.  This is used in some cases to ensure kernels across
    * multiple devices run concurrently. */
-  if (pthread_barrier_init(&barrier, NULL, num_devices) != 0) {
+  if (pthread_barrier_init(&barrier, NULL, num_threads) != 0) {
     fprintf(stderr, "pthread_barrier_init() failed.\n");
     exit(-1);
   }
 
-  args = calloc(num_devices, sizeof(thread_args));
-  if (args == NULL) {
+  args = calloc(num_threads, sizeof(thread_args));
+  threads = calloc(num_threads, sizeof(pthread_t));
+  if ((args == NULL) || (threads == NULL)) {
     fprintf(stderr, "Error while creating thread arg array.\n");
     exit(-1);
   }
@@ -731,8 +807,8 @@ int main(int ac, char **av) {
     printf("Table generation started on %s...\n\n", time_str);  fflush(stdout);
   }
 
-  /* Spin up one host thread per GPU. */
-  for (i = 0; i < num_devices; i++) {
+  /* Spin up one host thread per GPU (or per CPU core). */
+  for (i = 0; i < num_threads; i++) {
     args[i].benchmark_mode = benchmark_mode;
     args[i].hash_type = hash_type;
     args[i].charset = charset;
@@ -743,20 +819,22 @@ int main(int ac, char **av) {
     args[i].chain_len = chain_len;
     args[i].filename = filename;
     args[i].initial_chains_per_execution = INITIAL_CHAINS_PER_EXECUTION;
+    args[i].cpu_thread_number = i;
     args[i].gpu.device_number = i;
-    args[i].gpu.device = devices[i];
+    if (!use_cpu)
+      args[i].gpu.device = devices[i];
 
     if (benchmark_mode)
       args[i].initial_chains_per_execution = total_chains_in_table;
 
-    if (pthread_create(&(threads[i]), NULL, &host_thread, &(args[i]))) {
+    if (pthread_create(&(threads[i]), NULL, use_cpu ? &cpu_host_thread : &host_thread, &(args[i]))) {
       perror("Failed to create thread");
       exit(-1);
     }
   }
 
   /* Wait for all threads to finish. */
-  for (i = 0; i < num_devices; i++) {
+  for (i = 0; i < num_threads; i++) {
     if (pthread_join(threads[i], NULL) != 0) {
       perror("Failed to join with thread");
       exit(-1);
@@ -825,5 +903,6 @@ int main(int ac, char **av) {
 
   pthread_barrier_destroy(&barrier);
   FREE(args);
+  FREE(threads);
   return 0;
 }
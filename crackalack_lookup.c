@@ -30,6 +30,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <locale.h>
 #include <pthread.h>
 #include <stdio.h>
@@ -43,37 +44,90 @@
 #include "charset.h"
 #include "clock.h"
 #include "cpu_rt_functions.h"
+#include "gpu_session.h"
+#include "hash_provider.h"
 #include "hash_validate.h"
 #include "misc.h"
+#include "rt_search.h"
 #include "rtc_decompress.h"
 #include "shared.h"
 #include "test_shared.h"  /* TODO: move hex_to_bytes() elsewhere. */
+#include "thread_pool.h"
 #include "verify.h"
 #include "version.h"
 
 #define VERBOSE 1
 #define PRECOMPUTE_KERNEL_PATH "precompute.cl"
-#define PRECOMPUTE_NTLM8_KERNEL_PATH "precompute_ntlm8.cl"
-#define PRECOMPUTE_NTLM9_KERNEL_PATH "precompute_ntlm9.cl"
 #define FALSE_ALARM_KERNEL_PATH "false_alarm_check.cl"
-#define FALSE_ALARM_NTLM8_KERNEL_PATH "false_alarm_check_ntlm8.cl"
-#define FALSE_ALARM_NTLM9_KERNEL_PATH "false_alarm_check_ntlm9.cl"
+#define SEARCH_TABLE_KERNEL_PATH "search_table.cl"
+
+/* When fewer than this many potential matches per CPU core need to be checked, the
+ * checks are done on the CPU, since it takes longer than that to set up the OpenCL
+ * context and kernel. */
+#define CPU_FALSE_ALARM_THRESHOLD_PER_CORE 64
+
+/* When false alarms are checked on GPUs, the candidates of several tables are checked
+ * together, since each check has a fixed cost (building the kernel, creating buffers,
+ * etc).  A batch is checked once it has this many candidates, which is enough work to
+ * keep a GPU busy... */
+#define FALSE_ALARM_BATCH_SIZE (64 * 1024)
+
+/* ... or once this many seconds have passed since its first table started, so that
+ * hashes are still cracked (and skipped in later tables) soon after their table is
+ * searched. */
+#define FALSE_ALARM_BATCH_SECONDS 10
+
+/* The number of potential start indices that a GPU checks per kernel run (unless the
+ * user gave a GWS on the command line).  This bounds the size of the device buffers
+ * and the run time of each kernel, and lets cracks be reported as each chunk
+ * finishes. */
+#define GPU_FALSE_ALARM_CHUNK_CANDIDATES (16 * 1024)
+
+/* When the table has fewer than this many chains per uncracked precomputed end index,
+ * the table is searched with a sort-merge join instead of one tree search per index.
+ * A tree search costs a few cache misses, while the merge streams the whole table once;
+ * on a 16M chain table, they break even at around one index per 500 chains. */
+#define MERGE_JOIN_CHAINS_PER_QUERY 512
+
+/* The number of precomputed end indices that a search thread takes at a time.  Threads
+ * take chunks until none are left, so they all finish at about the same time.  A
+ * chunk's end indices (16KB) fit in the L1 cache along with the searches' tree nodes. */
+#define SEARCH_CHUNK_SIZE 2048
+
+/* When there are at least this many uncracked precomputed end indices per chain in the
+ * table, the table is searched with a hash join: its end indices are scanned once, and
+ * each is looked up in a hash set of the precomputed end indices.  A lookup in the set
+ * is a random memory access, while the merge join reads the sorted indices in order;
+ * on a 16M chain table, a lookup costs about as much as twelve merge steps. */
+#define HASH_JOIN_QUERIES_PER_CHAIN 16
+
+/* When tables are searched on GPUs, each table's end indices are sent to them in
+ * chunks of this many chains (64MB). */
+#define GPU_SEARCH_CHUNK_CHAINS (8 * 1024 * 1024)
+
+/* The initial number of hits that the GPU table search has room for.  When a chunk of
+ * a table has more, the buffer is grown and the chunk is searched again. */
+#define GPU_SEARCH_INITIAL_HITS (64 * 1024)
+
+/* The methods for searching a table (see choose_search_method()). */
+#define SEARCH_METHOD_TREE 1
+#define SEARCH_METHOD_MERGE_JOIN 2
+#define SEARCH_METHOD_HASH_JOIN 3
 
 #define HASH_FILE_FORMAT_PLAIN 1
 #define HASH_FILE_FORMAT_PWDUMP 2
 
 
-/* Struct to form a linked list of precomputed end indices, and potential start indices (which are usually false alarms). */
+/* Struct to form a linked list of each hash's precomputed end indices.  (The potential
+ * start indices that searching the tables finds are kept in hit_buffers and
+ * false_alarm_candidates instead.) */
 struct _precomputed_and_potential_indices {
   char *username;  /* Non-NULL if loaded file format is pwdump. */
   char *hash;
   cl_ulong *precomputed_end_indices;
   cl_uint num_precomputed_end_indices;
 
-  cl_ulong *potential_start_indices;
-  unsigned int num_potential_start_indices;
-  unsigned int potential_start_indices_size;
-  unsigned int *potential_start_index_positions; /* Buffer size is always num_potential_start_indices. */
+  cl_ulong hash_base_index;  /* Set by check_false_alarms(). */
 
   char *plaintext;        /* Set if hash is cracked. */
   char *index_filename;   /* File path containing the ".index" file. */
@@ -121,25 +175,157 @@ typedef struct {
   /* Length is always num_potential_start_indices. */
   cl_ulong *hash_base_indices;
 
+  /* The hash that each potential start index belongs to (false alarm checks on GPUs
+   * only).  Length is always num_potential_start_indices. */
+  precomputed_and_potential_indices **ppi_refs;
+
   gpu_dev gpu;
 } thread_args;
 
 
-/* Struct to pass to binary search threads. */
+/* Struct to pass arguments to a CPU precomputation or false alarm thread. */
 typedef struct {
-  cl_ulong *rainbow_table;
-  unsigned int num_chains;
-  precomputed_and_potential_indices *ppi_head;
+  thread_args *args;
+  uint64_t *output;
   unsigned int thread_number;
   unsigned int total_threads;
+
+  /* The potential start indices, sorted by chain position (false alarm checks only). */
+  unsigned int *candidate_order;
+} cpu_thread_args;
+
+
+/* Used to sort potential start indices by their chain position. */
+typedef struct {
+  unsigned int position;
+  unsigned int candidate;
+} candidate_position;
+
+
+/* A potential start index that a table search found (which is usually a false
+ * alarm), the hash it was found for, and its position within the chain. */
+typedef struct {
+  cl_ulong start_index;
+  precomputed_and_potential_indices *ppi;
+  unsigned int position;
+} search_hit;
+
+
+/* The number of hits in each block of a hit buffer. */
+#define HIT_BLOCK_SIZE 4096
+
+/* Hit buffers are a list of fixed-size blocks, so that they never need to be copied
+ * while they grow.  The blocks are kept after each table and re-used for the next
+ * one. */
+struct _hit_block {
+  search_hit hits[HIT_BLOCK_SIZE];
+  unsigned int num_hits;
+  struct _hit_block *next;
+};
+typedef struct _hit_block hit_block;
+
+
+/* The hits that one search thread found in a table.  Each thread has its own, so no
+ * locking is needed to add to it. */
+typedef struct {
+  hit_block *first;
+  hit_block *current;  /* The block being added to (NULL if empty). */
+  unsigned int num_hits;
+} hit_buffer;
+
+
+/* All the hits found in a table, flattened into the arrays that the false alarm
+ * checks take. */
+typedef struct {
+  cl_ulong *start_indices;
+  unsigned int *positions;
+  precomputed_and_potential_indices **ppi_refs;
+  unsigned int num_candidates;
+} false_alarm_candidates;
+
+
+/* A range of work for a search thread: positions [first, last) of one hash's
+ * precomputed end indices for tree searches, of sorted_end_indices for merge joins, or
+ * of the table's chains for hash joins.  (The ppi and hash number are only set for
+ * tree searches.) */
+typedef struct {
+  precomputed_and_potential_indices *ppi;
+  unsigned int hash_number;
+  unsigned int first;
+  unsigned int last;
+} search_chunk;
+
+
+/* A match that the GPU table search found (see CL/search_table.cl): a precomputed end
+ * index, identified by its hash's number and its position, and the chain in the table
+ * that has the same end index. */
+typedef struct {
+  cl_uint hash_number;
+  cl_uint position;
+  cl_uint chain;
+} gpu_search_hit;
+
+
+/* The state of one GPU for searching tables.  The kernel, the sorted precomputed end
+ * indices, and the buffers below are created once and kept for all tables; the rest is
+ * set for each table. */
+typedef struct {
+  thread_args *args;
+  cl_context context;
+  cl_command_queue queue;
+  cl_program program;
+  cl_kernel kernel;
+  cl_mem sorted_end_indices_buffer;
+  cl_mem num_sorted_end_indices_buffer;
+  cl_mem cracked_buffer;
+
+  /* Two sets of buffers for chunks of the table, so that the next chunk can be queued
+   * up while the hits of the previous one are collected (see host_thread_search()). */
+  cl_mem table_end_indices_buffer[2];
+  cl_mem num_table_end_indices_buffer[2];
+  cl_mem first_buffer[2];
+  cl_mem chain_offset_buffer[2];
+  cl_mem max_hits_buffer[2];
+  cl_mem num_hits_buffer[2];
+  cl_mem hits_buffer[2];
+  gpu_search_hit *hits_block[2];  /* Where hits_buffer is read into. */
+  unsigned int max_hits[2];       /* The number of hits that hits_buffer holds. */
+
+  /* The range of the table's chains that this GPU searches. */
+  const rt_search_table *table;
+  unsigned int first_chain;
+  unsigned int last_chain;
+
+  /* The hits found in the table. */
+  gpu_search_hit *hits;
+  unsigned int num_hits;
+  unsigned int hits_size;
+} gpu_searcher;
+
+
+/* Struct to pass to binary search threads. */
+typedef struct {
+  const rt_search_table *table;
+  hit_buffer *hits;
 } search_thread_args;
 
 
+/* The false alarm checks of a batch of tables, which run while the next tables are
+ * searched. */
+typedef struct {
+  precomputed_and_potential_indices *ppi_head;
+  false_alarm_candidates candidates;
+  thread_args *args;
+  unsigned int first_table;
+  unsigned int last_table;
+  struct timespec start_time;  /* When the first table's search started. */
+} false_alarm_stage;
+
+
 /* Struct to hold node in linked list of preloaded tables. */
 struct _preloaded_table {
   char *filepath;
-  cl_ulong *rainbow_table;
-  unsigned int num_chains;
+  rt_search_table table;
   struct _preloaded_table *next;
 };
 typedef struct _preloaded_table preloaded_table;
@@ -152,6 +338,7 @@ typedef struct {
 unsigned int count_tables(char *dir);
 void find_rt_params(char *dir, rt_parameters *rt_params);
 void free_loaded_hashes(char **usernames, char **hashes);
+void *cpu_thread_false_alarm(void *ptr);
 void *host_thread_false_alarm(void *ptr);
 void *preloading_thread(void *ptr);
 void print_eta_precompute();
@@ -176,9 +363,6 @@ uint64_t num_falsealarms = 0, num_chains_processed = 0;
  * processed, respectively. */
 unsigned int num_cracked = 0, num_tables_processed = 0;
 
-/* Mutex to protect the precomputed_and_potential_indices array. _*/
-pthread_mutex_t ppi_mutex = PTHREAD_MUTEX_INITIALIZER;
-
 /* Barrier to ensure that kernels on multiple devices are all run at the same time.
  * The closed-source AMD driver on Windows effectively blocks other devices while
  * one kernel is running; this ensures parallelization in that environment, since
@@ -195,6 +379,12 @@ size_t user_provided_gws = 0;
 /* The platform number to disable (-1 to not disable any). */
 int disable_platform = -1;
 
+/* Set to 1 when the user requested that the CPU be used instead of GPUs. */
+unsigned int use_cpu = 0;
+
+/* Set to 1 when the user requested that tables be searched on the GPUs. */
+unsigned int use_gpu_search = 0;
+
 /* The total number of precomputed indices loaded into memory.  Each one of these is
  * a cl_ulong (8 bytes). */
 uint64_t total_precomputed_indices_loaded = 0;
@@ -225,6 +415,10 @@ pthread_cond_t condition_continue_loading_tables = PTHREAD_COND_INITIALIZER;
 /* The lock for the preloaded tables system. */
 pthread_mutex_t preloaded_tables_lock = PTHREAD_MUTEX_INITIALIZER;
 
+/* Serializes the checking and saving of cracked hashes, since each GPU reports its
+ * own as soon as they're found. */
+pthread_mutex_t cracked_hash_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /* The time at which precomputation begins. */
 struct timespec precompute_start_time = {0};
 
@@ -234,6 +428,44 @@ struct timespec search_start_time = {0};
 /* Number of uncracked hashes. */
 unsigned int num_hashes = 0;
 
+/* The worker threads that table searching, false alarm checking, and result collation
+ * run on.  These are started once and kept for all tables. */
+thread_pool *worker_pool = NULL;
+
+/* The hit buffer of each search thread. */
+hit_buffer *hit_buffers = NULL;
+unsigned int num_hit_buffers = 0;
+
+/* The work for the current table search, split into chunks.  Search threads take the
+ * next chunk by atomically incrementing next_search_chunk. */
+search_chunk *search_chunks = NULL;
+unsigned int num_search_chunks = 0, search_chunks_size = 0;
+unsigned int next_search_chunk = 0;
+
+/* All hashes' precomputed end indices, sorted, for the sort-merge join.  These are
+ * built the first time a table is merge-joined, and re-used for all tables after. */
+rt_tagged_end_index *sorted_end_indices = NULL;
+unsigned int num_sorted_end_indices = 0;
+
+/* All hashes' precomputed end indices in a hash set, for the hash join.  As with the
+ * sorted end indices, this is built the first time it is needed. */
+rt_end_index_set end_index_set = {0};
+
+/* Every hash, in list order.  The search methods refer to hashes by their number in
+ * this array. */
+precomputed_and_potential_indices **numbered_hashes = NULL;
+unsigned int num_numbered_hashes = 0;
+
+/* Which of the numbered hashes were cracked before the current table search started.
+ * The joins skip these. */
+unsigned char *cracked_hashes = NULL;
+
+/* The state of each GPU for searching tables (when use_gpu_search is set). */
+gpu_searcher gpu_searchers[MAX_NUM_DEVICES] = {0};
+
+/* The context and kernels of each GPU, which are kept for the whole lookup. */
+gpu_session gpu_sessions[MAX_NUM_DEVICES];
+
 /* Number of hashes precomputed so far. */
 unsigned int num_hashes_precomputed = 0;
 
@@ -245,185 +477,461 @@ unsigned int num_hashes_precomputed_total = 0;
  * alarm checking is done by the main thread. */
 #define MAX_PRELOAD_NUM 2
 
-#define LOCK_PPI() \
-  if (pthread_mutex_lock(&ppi_mutex)) { perror("Failed to lock mutex"); exit(-1); }
+/* Adds a potential start index (and position within the chain) to check for false
+ * alarms to a search thread's hit buffer. */
+void add_search_hit(hit_buffer *hb, precomputed_and_potential_indices *ppi, cl_ulong start, unsigned int position) {
+  hit_block *block = hb->current;
+  search_hit *hit = NULL;
+
+
+  /* Move on to the next block when this one is full, allocating it if this buffer
+   * has never needed it before. */
+  if ((block == NULL) || (block->num_hits == HIT_BLOCK_SIZE)) {
+    block = (block == NULL) ? hb->first : block->next;
+    if (block == NULL) {
+      block = calloc(1, sizeof(hit_block));
+      if (block == NULL) {
+	fprintf(stderr, "Failed to allocate hit buffer block.\n");
+	exit(-1);
+      }
 
-#define UNLOCK_PPI() \
-  if (pthread_mutex_unlock(&ppi_mutex)) { perror("Failed to unlock mutex"); exit(-1); }
+      if (hb->current == NULL)
+	hb->first = block;
+      else
+	hb->current->next = block;
+    }
 
+    block->num_hits = 0;
+    hb->current = block;
+  }
 
-/* Adds a potential start index (and position within the chain) to check for false
- * alarms. */
-void add_potential_start_index_and_position(precomputed_and_potential_indices *ppi, cl_ulong start, unsigned int position) {
-  #define POTENTIAL_START_INDICES_INITIAL_SIZE 16
-
-  LOCK_PPI();
-
-  /* Initialize the potential_start_indices buffer if it isn't already. */
-  if (ppi->potential_start_indices == NULL) {
-    ppi->potential_start_indices = calloc(POTENTIAL_START_INDICES_INITIAL_SIZE, sizeof(cl_ulong));
-    ppi->potential_start_index_positions = calloc(POTENTIAL_START_INDICES_INITIAL_SIZE, sizeof(cl_ulong));
-    if ((ppi->potential_start_indices == NULL) || (ppi->potential_start_index_positions == NULL)) {
-      fprintf(stderr, "Failed to initialize potential_start_indices / potential_start_index_positions buffer.\n");
-      exit(-1);
+  hit = &(block->hits[block->num_hits]);
+  hit->start_index = start;
+  hit->ppi = ppi;
+  hit->position = position;
+  block->num_hits++;
+  hb->num_hits++;
+}
+
+
+/* Empties a hit buffer, keeping its blocks for re-use. */
+void reset_hit_buffer(hit_buffer *hb) {
+  hb->current = NULL;
+  hb->num_hits = 0;
+}
+
+
+/* Frees the hit buffers of all search threads. */
+void free_hit_buffers() {
+  hit_block *block = NULL, *next = NULL;
+  unsigned int i = 0;
+
+
+  for (i = 0; i < num_hit_buffers; i++) {
+    for (block = hit_buffers[i].first; block != NULL; block = next) {
+      next = block->next;
+      FREE(block);
+    }
+  }
+
+  FREE(hit_buffers);
+  num_hit_buffers = 0;
+}
+
+
+/* The arguments to a task that copies one hit buffer into the false alarm candidates. */
+struct _collate_args {
+  hit_buffer *hits;
+  false_alarm_candidates *candidates;
+  unsigned int offset;  /* Where this buffer's hits start in the candidates. */
+};
+typedef struct _collate_args collate_args;
+
+
+/* Copies the hits in one hit buffer into its slice of the false alarm candidates, then
+ * empties the hit buffer. */
+void *collate_hit_buffer(void *ptr) {
+  collate_args *args = (collate_args *)ptr;
+  false_alarm_candidates *candidates = args->candidates;
+  hit_block *block = NULL;
+  unsigned int n = args->offset, j = 0;
+
+
+  /* The blocks up to and including the current one are in use. */
+  for (block = args->hits->first; block != NULL; block = (block == args->hits->current) ? NULL : block->next) {
+    for (j = 0; j < block->num_hits; j++, n++) {
+      candidates->start_indices[n] = block->hits[j].start_index;
+      candidates->positions[n] = block->hits[j].position;
+      candidates->ppi_refs[n] = block->hits[j].ppi;
     }
-    ppi->potential_start_indices_size = POTENTIAL_START_INDICES_INITIAL_SIZE;
   }
 
-  /* If its time to re-size the array... */
-  if (ppi->num_potential_start_indices == ppi->potential_start_indices_size) {
-    unsigned int new_size_in_ulongs = ppi->potential_start_indices_size * 2;
+  reset_hit_buffer(args->hits);
+  return NULL;
+}
+
+
+/* Merges all the search threads' hits into one set of false alarm candidates.  Each
+ * hit buffer is copied into its own slice of the candidates by the worker pool.  The
+ * hit buffers are then emptied. */
+void merge_hit_buffers(false_alarm_candidates *candidates) {
+  collate_args *args = NULL;
+  unsigned int num_candidates = 0, i = 0;
+  thread_pool_group group = {0};
+
+
+  memset(candidates, 0, sizeof(false_alarm_candidates));
+  for (i = 0; i < num_hit_buffers; i++)
+    num_candidates += hit_buffers[i].num_hits;
+
+  if (num_candidates == 0)
+    return;
+
+  candidates->start_indices = calloc(num_candidates, sizeof(cl_ulong));
+  candidates->positions = calloc(num_candidates, sizeof(unsigned int));
+  candidates->ppi_refs = calloc(num_candidates, sizeof(precomputed_and_potential_indices *));
+  args = calloc(num_hit_buffers, sizeof(collate_args));
+  if ((candidates->start_indices == NULL) || (candidates->positions == NULL) || (candidates->ppi_refs == NULL) || (args == NULL)) {
+    fprintf(stderr, "Error while creating buffer for potential start indices/positions/ppi refs.\n");
+    exit(-1);
+  }
+
+  for (i = 0; i < num_hit_buffers; i++) {
+    args[i].hits = &(hit_buffers[i]);
+    args[i].candidates = candidates;
+    args[i].offset = candidates->num_candidates;
+    candidates->num_candidates += hit_buffers[i].num_hits;
+
+    if (hit_buffers[i].num_hits > 0)
+      thread_pool_submit(worker_pool, &group, &collate_hit_buffer, &(args[i]));
+  }
+  thread_pool_wait(worker_pool, &group);
+
+  FREE(args);
+}
+
+
+/* Frees a set of false alarm candidates. */
+void free_false_alarm_candidates(false_alarm_candidates *candidates) {
+  FREE(candidates->start_indices);
+  FREE(candidates->positions);
+  FREE(candidates->ppi_refs);
+  candidates->num_candidates = 0;
+}
+
+
+/* Appends one table's false alarm candidates to a batch of them, and frees them. */
+void append_false_alarm_candidates(false_alarm_candidates *batch, false_alarm_candidates *candidates) {
+  unsigned int num_candidates = batch->num_candidates + candidates->num_candidates;
 
-    /*printf("Resizing array from %u to %u.\n", ppi->potential_start_indices_size, new_size_in_ulongs);*/
-    ppi->potential_start_indices = recalloc(ppi->potential_start_indices, new_size_in_ulongs * sizeof(cl_ulong), ppi->potential_start_indices_size * sizeof(cl_ulong));
-    ppi->potential_start_index_positions = recalloc(ppi->potential_start_index_positions, new_size_in_ulongs * sizeof(cl_ulong), ppi->potential_start_indices_size * sizeof(cl_ulong));
-    if ((ppi->potential_start_indices == NULL) || (ppi->potential_start_index_positions == NULL)) {
-      fprintf(stderr, "Failed to re-allocate potential_start_indices/potential_start_index_positions buffer to %u.\n", new_size_in_ulongs);
+
+  /* When the batch is empty, the table's candidates can simply be taken over. */
+  if (batch->num_candidates == 0) {
+    free_false_alarm_candidates(batch);
+    *batch = *candidates;
+    memset(candidates, 0, sizeof(false_alarm_candidates));
+    return;
+  }
+
+  if (candidates->num_candidates > 0) {
+    batch->start_indices = realloc(batch->start_indices, num_candidates * sizeof(cl_ulong));
+    batch->positions = realloc(batch->positions, num_candidates * sizeof(unsigned int));
+    batch->ppi_refs = realloc(batch->ppi_refs, num_candidates * sizeof(precomputed_and_potential_indices *));
+    if ((batch->start_indices == NULL) || (batch->positions == NULL) || (batch->ppi_refs == NULL)) {
+      fprintf(stderr, "Error while growing false alarm candidate batch.\n");
       exit(-1);
     }
-    ppi->potential_start_indices_size = new_size_in_ulongs;
+
+    memcpy(&(batch->start_indices[batch->num_candidates]), candidates->start_indices, candidates->num_candidates * sizeof(cl_ulong));
+    memcpy(&(batch->positions[batch->num_candidates]), candidates->positions, candidates->num_candidates * sizeof(unsigned int));
+    memcpy(&(batch->ppi_refs[batch->num_candidates]), candidates->ppi_refs, candidates->num_candidates * sizeof(precomputed_and_potential_indices *));
+    batch->num_candidates = num_candidates;
   }
-  ppi->potential_start_indices[ppi->num_potential_start_indices] = start;
-  ppi->potential_start_index_positions[ppi->num_potential_start_indices] = position;
-  ppi->num_potential_start_indices++;
 
-  UNLOCK_PPI();
+  free_false_alarm_candidates(candidates);
 }
 
 
-void check_false_alarms(precomputed_and_potential_indices *ppi, thread_args *args) {
-  pthread_t threads[MAX_NUM_DEVICES] = {0};
+/* Removes the candidates of hashes that were cracked after the candidates were found
+ * (i.e.: by the previous table's false alarm checks). */
+void drop_cracked_candidates(false_alarm_candidates *candidates) {
+  unsigned int i = 0, n = 0;
+
+
+  for (i = 0; i < candidates->num_candidates; i++) {
+    if (candidates->ppi_refs[i]->plaintext != NULL)
+      continue;
+
+    candidates->start_indices[n] = candidates->start_indices[i];
+    candidates->positions[n] = candidates->positions[i];
+    candidates->ppi_refs[n] = candidates->ppi_refs[i];
+    n++;
+  }
+  candidates->num_candidates = n;
+}
+
+
+/* Frees the precomputed end indices of cracked hashes.  Table searches may be reading
+ * these while a false alarm check cracks their hash, so this is only done between
+ * searches. */
+void free_cracked_end_indices(precomputed_and_potential_indices *ppi_head) {
+  precomputed_and_potential_indices *ppi_cur = NULL;
+
+
+  for (ppi_cur = ppi_head; ppi_cur != NULL; ppi_cur = ppi_cur->next) {
+    if ((ppi_cur->plaintext != NULL) && (ppi_cur->precomputed_end_indices != NULL)) {
+      ppi_cur->num_precomputed_end_indices = 0;
+      FREE(ppi_cur->precomputed_end_indices);
+    }
+  }
+}
+
+
+/* Sorts candidates by their chain position (for qsort()). */
+int compare_candidate_positions(const void *a, const void *b) {
+  const candidate_position *ca = (const candidate_position *)a, *cb = (const candidate_position *)b;
+
+  if (ca->position < cb->position)
+    return -1;
+  else if (ca->position > cb->position)
+    return 1;
+  return 0;
+}
+
+
+/* Checks a plaintext index that a false alarm check found for a hash.  If it really
+ * does crack the hash, the plaintext is saved in the ppi and in the pot file, and
+ * the user is told. */
+void check_false_alarm_result(thread_args *args, precomputed_and_potential_indices *ppi, uint64_t plaintext_index) {
+  char plaintext[MAX_PLAINTEXT_LEN] = {0};
+  unsigned char hash[MAX_HASH_OUTPUT_LEN] = {0};
+  char hash_hex[(sizeof(hash) * 2) + 1] = {0};
+  uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
+  unsigned int plaintext_len = 0, charset_len = strlen(args->charset);
+  const hash_provider *hp = get_hash_provider(args->hash_type);
+
+
+  fill_plaintext_space_table(charset_len, args->plaintext_len_min, args->plaintext_len_max, plaintext_space_up_to_index);
+  index_to_plaintext(plaintext_index, args->charset, charset_len, args->plaintext_len_min, args->plaintext_len_max, plaintext_space_up_to_index, plaintext, &plaintext_len);
+
+  /* Double check results to weed out super false alarms. */
+  if (hp != NULL) {
+    hp->hash(plaintext, plaintext_len, hash);
+    if (!bytes_to_hex(hash, hp->hash_len, hash_hex, sizeof(hash_hex)) || \
+	(strcmp(hash_hex, ppi->hash) != 0)) {
+      /*printf("Found super false positive!: %s('%s') != %s\n", hp->name, plaintext, ppi->hash);*/
+      return;
+    }
+  } else
+    printf("WARNING: CPU code to double-check this cracked hash has not yet been added.  There is a 60%% chance this is a false positive!  A workaround is to use John The Ripper to validate this result(s).\n");
+
+  pthread_mutex_lock(&cracked_hash_lock);
+
+  /* A batch may hold more than one candidate that cracks the same hash (i.e.: when
+   * tables share chains); only the first is used. */
+  if (ppi->plaintext == NULL) {
+
+    /* Its official: we cracked a hash! */
+
+    /* Save the plaintext, save the hash/plaintext combo into the pot file, and tell
+     * the user.  (The precomputed end indices are no longer useful, but the next
+     * table's search may still be reading them; they are freed by search_tables().) */
+    ppi->plaintext = strdup(plaintext);
+
+    save_cracked_hash(ppi, args->hash_type);
+    printf("%sHASH CRACKED => %s:%s%s\n", GREENB, (ppi->username != NULL) ? ppi->username : ppi->hash, plaintext, CLR);  fflush(stdout);
+  }
+
+  pthread_mutex_unlock(&cracked_hash_lock);
+}
+
+
+/* Returns the order of the candidates when sorted by chain position, so that the
+ * chains walked side by side (in a SIMD batch on the CPU, or in a wavefront on a GPU)
+ * all end at about the same time.  The caller must free the returned array. */
+unsigned int *sort_candidates_by_position(unsigned int *positions, unsigned int num_candidates) {
+  candidate_position *candidate_positions = NULL;
+  unsigned int *candidate_order = NULL;
+  unsigned int i = 0;
+
+
+  candidate_positions = calloc(num_candidates, sizeof(candidate_position));
+  candidate_order = calloc(num_candidates, sizeof(unsigned int));
+  if ((candidate_positions == NULL) || (candidate_order == NULL)) {
+    fprintf(stderr, "Error while allocating buffers to sort false alarm candidates.\n");
+    exit(-1);
+  }
+
+  for (i = 0; i < num_candidates; i++) {
+    candidate_positions[i].position = positions[i];
+    candidate_positions[i].candidate = i;
+  }
+  qsort(candidate_positions, num_candidates, sizeof(candidate_position), compare_candidate_positions);
+
+  for (i = 0; i < num_candidates; i++)
+    candidate_order[i] = candidate_positions[i].candidate;
+
+  FREE(candidate_positions);
+  return candidate_order;
+}
+
+
+/* Checks the potential start indices set in the first thread args on all CPU cores,
+ * in the given order (see sort_candidates_by_position()).  The results are stored in
+ * the same form that the GPU threads produce: one plaintext index per potential start
+ * index, or zero if it was a false alarm. */
+void check_false_alarms_cpu(thread_args *args, unsigned int *candidate_order) {
+  cpu_thread_args *cpu_args = NULL;
+  unsigned int num_threads = get_num_cpu_cores(), num_candidates = args->num_potential_start_indices, i = 0;
+  thread_pool_group group = {0};
+
+
+  args->results = calloc(num_candidates, sizeof(uint64_t));
+  cpu_args = calloc(num_threads, sizeof(cpu_thread_args));
+  if ((args->results == NULL) || (cpu_args == NULL)) {
+    fprintf(stderr, "Error while allocating buffers for CPU false alarm checks.\n");
+    exit(-1);
+  }
+  args->num_results = num_candidates;
+
+  for (i = 0; i < num_threads; i++) {
+    cpu_args[i].args = args;
+    cpu_args[i].output = args->results;
+    cpu_args[i].thread_number = i;
+    cpu_args[i].total_threads = num_threads;
+    cpu_args[i].candidate_order = candidate_order;
+    thread_pool_submit(worker_pool, &group, &cpu_thread_false_alarm, &(cpu_args[i]));
+  }
+
+  /* Wait for all tasks to finish. */
+  thread_pool_wait(worker_pool, &group);
+
+  FREE(cpu_args);
+}
+
+
+/* Checks the false alarm candidates found in a table, and frees them. */
+void check_false_alarms(precomputed_and_potential_indices *ppi, false_alarm_candidates *candidates, thread_args *args) {
   char time_str[128] = {0};
   struct timespec start_time = {0};
   cl_ulong plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
 
-  unsigned int num_potential_start_indices = 0, i = 0, j = 0;
+  unsigned int num_potential_start_indices = candidates->num_candidates, i = 0;
   unsigned int total_devices = args[0].total_devices;
   cl_ulong plaintext_space_total = 0;
   double time_delta = 0.0;
 
   precomputed_and_potential_indices *ppi_cur = ppi;
-  cl_ulong *potential_start_indices = NULL, *hash_base_indices = NULL;
-  unsigned int *potential_start_index_positions = NULL;
-  precomputed_and_potential_indices **ppi_refs = NULL;
+  cl_ulong *potential_start_indices = candidates->start_indices, *hash_base_indices = NULL;
+  unsigned int *potential_start_index_positions = candidates->positions;
+  precomputed_and_potential_indices **ppi_refs = candidates->ppi_refs, **sorted_ppi_refs = NULL;
+  thread_pool_group group = {0};
 
+  unsigned int *candidate_order = NULL, *sorted_positions = NULL;
+  cl_ulong *sorted_start_indices = NULL, *sorted_hash_base_indices = NULL;
 
-  /* First count all the potential start indices. */
-  while(ppi_cur) {
-    num_potential_start_indices += ppi_cur->num_potential_start_indices;
-    ppi_cur = ppi_cur->next;
-  }
+
+  drop_cracked_candidates(candidates);
+  num_potential_start_indices = candidates->num_candidates;
 
   /* If no potential matches were found, there's nothing else to do. */
   if (num_potential_start_indices == 0) {
     printf("No matches found in table.\n");
+    free_false_alarm_candidates(candidates);
     return;
   }
   printf("  Checking %u potential matches...\n", num_potential_start_indices);  fflush(stdout);
   num_falsealarms += num_potential_start_indices;
 
-  /* Allocate a buffer to hold them all. */
-  potential_start_indices = calloc(num_potential_start_indices, sizeof(cl_ulong));
-  potential_start_index_positions = calloc(num_potential_start_indices, sizeof(cl_ulong));
   hash_base_indices = calloc(num_potential_start_indices, sizeof(cl_ulong));
-  ppi_refs = calloc(num_potential_start_indices, sizeof(precomputed_and_potential_indices *));
-  if ((potential_start_indices == NULL) || (potential_start_index_positions == NULL) || (hash_base_indices == NULL) || (ppi_refs == NULL)) {
-    fprintf(stderr, "Error while creating buffer for potential start indices/positions/hash indices/ppi refs.\n");
+  if (hash_base_indices == NULL) {
+    fprintf(stderr, "Error while creating buffer for hash indices.\n");
     exit(-1);
   }
 
   plaintext_space_total = fill_plaintext_space_table(strlen(args->charset), args->plaintext_len_min, args->plaintext_len_max, plaintext_space_up_to_index);
 
-  /* Collate all the start indices into one buffer. */
-  ppi_cur = ppi;
+  /* We always use position 0 here.  When the GPU code is comparing indices, it will
+   * add in the current position. */
   while(ppi_cur) {
     unsigned char hash[MAX_HASH_OUTPUT_LEN] = {0};
     unsigned int hash_len = hex_to_bytes(ppi_cur->hash, sizeof(hash), hash);
-    cl_ulong hash_base_index = hash_to_index(hash, hash_len, args->reduction_offset, plaintext_space_total, 0);  /* We always use position 0 here.  When the GPU code is comparing indices, it will add in the current position. */
-
 
-    if (ppi_cur->plaintext == NULL) {
-      for (i = 0; i < ppi_cur->num_potential_start_indices; i++, j++) {
-	potential_start_indices[j] = ppi_cur->potential_start_indices[i];
-	potential_start_index_positions[j] = ppi_cur->potential_start_index_positions[i];
-	hash_base_indices[j] = hash_base_index;
-
-	/* For this index, hold a reference to the ppi struct.  This later lets us find
-	 * the ppi, given a result index from the GPU. */
-	ppi_refs[j] = ppi_cur;
-      }
-    }
 
+    ppi_cur->hash_base_index = hash_to_index(hash, hash_len, args->reduction_offset, plaintext_space_total, 0);
     ppi_cur = ppi_cur->next;
   }
 
+  /* The ppi_refs hold a reference to the ppi struct of each candidate.  This later
+   * lets us find the ppi, given a result index from the GPU. */
+  for (i = 0; i < num_potential_start_indices; i++)
+    hash_base_indices[i] = ppi_refs[i]->hash_base_index;
+
   /*for (i = 0; i < num_potential_start_indices; i++)
     printf("Start point: %lu; Chain position: %u; hash base index: %lu\n", potential_start_indices[i], potential_start_index_positions[i], hash_base_indices[i]);*/
 
   /* Start the timer false alarm checking. */
   start_timer(&start_time);
 
-  /* Start one thread to control each GPU. */
-  for (i = 0; i < total_devices; i++) {
+  candidate_order = sort_candidates_by_position(potential_start_index_positions, num_potential_start_indices);
 
-    /* Each thread gets the same reference to the list of potential start indices. */
-    args[i].potential_start_indices = potential_start_indices;
-    args[i].num_potential_start_indices = num_potential_start_indices;
-    args[i].potential_start_index_positions = potential_start_index_positions;
-    args[i].hash_base_indices = hash_base_indices;
+  /* When no GPUs are in use, or when there are so few potential matches that the
+   * OpenCL setup would dominate, check them on the CPU instead. */
+  if (use_cpu || (total_devices == 0) || (num_potential_start_indices < (CPU_FALSE_ALARM_THRESHOLD_PER_CORE * get_num_cpu_cores()))) {
+    args[0].potential_start_indices = potential_start_indices;
+    args[0].num_potential_start_indices = num_potential_start_indices;
+    args[0].potential_start_index_positions = potential_start_index_positions;
+    args[0].hash_base_indices = hash_base_indices;
 
-    if (pthread_create(&(threads[i]), NULL, &host_thread_false_alarm, &(args[i]))) {
-      perror("Failed to create thread");
-      exit(-1);
+    check_false_alarms_cpu(args, candidate_order);
+    for (i = 0; i < args[0].num_results; i++) {
+      if (args[0].results[i] != 0)
+	check_false_alarm_result(&(args[0]), ppi_refs[i], args[0].results[i]);
     }
-  }
+  } else {
 
-  /* Wait for all threads to finish. */
-  for (i = 0; i < total_devices; i++) {
-    if (pthread_join(threads[i], NULL) != 0) {
-      perror("Failed to join with thread");
+    /* The GPUs get the candidates in chain position order.  A wavefront is made of
+     * neighbouring work items, so its lanes then walk chains of about the same length
+     * instead of idling while the longest one finishes.  Each device checks every
+     * total_devices'th candidate, so each still gets an equal share of the short and
+     * long chains. */
+    sorted_start_indices = calloc(num_potential_start_indices, sizeof(cl_ulong));
+    sorted_positions = calloc(num_potential_start_indices, sizeof(unsigned int));
+    sorted_hash_base_indices = calloc(num_potential_start_indices, sizeof(cl_ulong));
+    sorted_ppi_refs = calloc(num_potential_start_indices, sizeof(precomputed_and_potential_indices *));
+    if ((sorted_start_indices == NULL) || (sorted_positions == NULL) || (sorted_hash_base_indices == NULL) || (sorted_ppi_refs == NULL)) {
+      fprintf(stderr, "Error while allocating buffers for sorted false alarm candidates.\n");
       exit(-1);
     }
-  }
-
-  /* Search for valid results, and update the ppi with the plaintext. */
-  for (i = 0; i < total_devices; i++) {
-    for (j = 0; j < args[i].num_results; j++) {
-      if (args[i].results[j] != 0) {
-	char plaintext[MAX_PLAINTEXT_LEN] = {0};
-	unsigned int plaintext_len = 0;
-
 
-	index_to_plaintext(args[i].results[j], args[i].charset, strlen(args[i].charset), args[i].plaintext_len_min, args[i].plaintext_len_max, plaintext_space_up_to_index, plaintext, &plaintext_len);
-
-	/* Double check NTLM results to weed out super false alarms. */
-	if (args[i].hash_type == HASH_NTLM) {
-	  unsigned char hash[16] = {0};
-	  char hash_hex[(sizeof(hash) * 2) + 1] = {0};
-
-
-	  ntlm_hash(plaintext, plaintext_len, hash);
-	  if (!bytes_to_hex(hash, sizeof(hash), hash_hex, sizeof(hash_hex)) || \
-	      (strcmp(hash_hex, ppi_refs[j]->hash) != 0)) {
-	    /*printf("Found super false positive!: NTLM('%s') != %s\n", plaintext, ppi_refs[j]->hash);*/
-	    continue;
-	  }
-	} else
-	  printf("WARNING: CPU code to double-check this cracked hash has not yet been added.  There is a 60%% chance this is a false positive!  A workaround is to use John The Ripper to validate this result(s).\n");
+    for (i = 0; i < num_potential_start_indices; i++) {
+      sorted_start_indices[i] = potential_start_indices[candidate_order[i]];
+      sorted_positions[i] = potential_start_index_positions[candidate_order[i]];
+      sorted_hash_base_indices[i] = hash_base_indices[candidate_order[i]];
+      sorted_ppi_refs[i] = ppi_refs[candidate_order[i]];
+    }
 
-	/* Its official: we cracked a hash! */
+    /* Run one task to control each GPU.  These wait on each other (see
+     * host_thread_false_alarm()), so the pool has at least one worker per device.
+     * Each one reports the hashes it cracks itself, as soon as they are found. */
+    for (i = 0; i < total_devices; i++) {
+
+      /* Each thread gets the same reference to the list of potential start indices. */
+      args[i].potential_start_indices = sorted_start_indices;
+      args[i].num_potential_start_indices = num_potential_start_indices;
+      args[i].potential_start_index_positions = sorted_positions;
+      args[i].hash_base_indices = sorted_hash_base_indices;
+      args[i].ppi_refs = sorted_ppi_refs;
+      thread_pool_submit(worker_pool, &group, &host_thread_false_alarm, &(args[i]));
+    }
 
-	/* Save the plaintext, clear the precomputed end indices list (since its
-	 * no longer useful, save the hash/plaintext combo into the pot file, and
-	 * tell the user. */
-	ppi_refs[j]->plaintext = strdup(plaintext);
-	ppi_refs[j]->num_precomputed_end_indices = 0;
-	FREE(ppi_refs[j]->precomputed_end_indices);
+    /* Wait for all tasks to finish. */
+    thread_pool_wait(worker_pool, &group);
 
-	save_cracked_hash(ppi_refs[j], args[i].hash_type);
-        printf("%sHASH CRACKED => %s:%s%s\n", GREENB, (ppi_refs[j]->username != NULL) ? ppi_refs[j]->username : ppi_refs[j]->hash, plaintext, CLR);  fflush(stdout);
-      }
-    }
+    FREE(sorted_start_indices);
+    FREE(sorted_positions);
+    FREE(sorted_hash_base_indices);
+    FREE(sorted_ppi_refs);
   }
   time_delta = get_elapsed(&start_time);
 
@@ -431,10 +939,9 @@ void check_false_alarms(precomputed_and_potential_indices *ppi, thread_args *arg
   seconds_to_human_time(time_str, sizeof(time_str), (unsigned int)time_delta);
   printf("  Completed false alarm checks in %s.\n", time_str);  fflush(stdout);
 
-  FREE(potential_start_indices);
-  FREE(potential_start_index_positions);
+  free_false_alarm_candidates(candidates);
+  FREE(candidate_order);
   FREE(hash_base_indices);
-  FREE(ppi_refs);
   FREE(args->results);
   args->num_results = 0;
 }
@@ -457,21 +964,6 @@ void check_memory_usage() {
 }
 
 
-/* Free all the potential start indices. */
-void clear_potential_start_indices(precomputed_and_potential_indices *ppi) {
-  precomputed_and_potential_indices *ppi_cur = ppi;
-
-
-  while(ppi_cur) {
-    FREE(ppi_cur->potential_start_indices);
-    FREE(ppi_cur->potential_start_index_positions);
-    ppi_cur->num_potential_start_indices = 0;
-
-    ppi_cur = ppi_cur->next;
-  }
-}
-
-
 /* Returns the total number of *.rt and *.rtc in all subdirectories of the
  * specified directory. */
 unsigned int count_tables(char *dir) {
@@ -601,10 +1093,7 @@ void free_precomputed_and_potential_indices(precomputed_and_potential_indices **
     ppi_next = ppi->next;
 
     FREE(ppi->precomputed_end_indices);
-    FREE(ppi->potential_start_indices);
-    FREE(ppi->potential_start_index_positions);
     FREE(ppi->index_filename);
-    ppi->num_potential_start_indices = 0;
     FREE(ppi->plaintext);
     FREE(ppi);
 
@@ -614,20 +1103,73 @@ void free_precomputed_and_potential_indices(precomputed_and_potential_indices **
 }
 
 
-/* Returns the number of CPU cores on this machine. */
-unsigned int get_num_cpu_cores() {
-#ifdef _WIN32
-  SYSTEM_INFO sysinfo = {0};
+/* A CPU thread which checks a subset of the potential start indices for false alarms.
+ * Batches of CHAIN_BATCH_SIZE chains (with similar end positions, since they are
+ * sorted) are walked together; chains drop out of the batch as soon as they match the
+ * hash or pass their end position. */
+void *cpu_thread_false_alarm(void *ptr) {
+  cpu_thread_args *cpu_args = (cpu_thread_args *)ptr;
+  thread_args *args = cpu_args->args;
+  char plaintexts[CHAIN_BATCH_SIZE * MAX_PLAINTEXT_LEN];
+  unsigned char hashes[CHAIN_BATCH_SIZE * MAX_HASH_OUTPUT_LEN];
+  unsigned int plaintext_lens[CHAIN_BATCH_SIZE];
+  unsigned int lanes[CHAIN_BATCH_SIZE];
+  uint64_t indices[CHAIN_BATCH_SIZE];
+  uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
+  unsigned int charset_len = strlen(args->charset), num_candidates = args->num_potential_start_indices;
+  unsigned int batch_start = 0, num_active = 0, candidate = 0, pos = 0, i = 0, j = 0;
+  uint64_t plaintext_space_total = fill_plaintext_space_table(charset_len, args->plaintext_len_min, args->plaintext_len_max, plaintext_space_up_to_index), index = 0, hash_base_index = 0;
+  reduction_context rc;
+
+
+  init_reduction_context(&rc, args->hash_type, args->charset, charset_len, args->plaintext_len_min, args->plaintext_len_max, plaintext_space_total);
+
+  for (batch_start = cpu_args->thread_number * CHAIN_BATCH_SIZE; batch_start < num_candidates; batch_start += cpu_args->total_threads * CHAIN_BATCH_SIZE) {
+    num_active = num_candidates - batch_start;
+    if (num_active > CHAIN_BATCH_SIZE)
+      num_active = CHAIN_BATCH_SIZE;
+
+    for (i = 0; i < num_active; i++) {
+      lanes[i] = cpu_args->candidate_order[batch_start + i];
+      indices[i] = args->potential_start_indices[lanes[i]];
+    }
 
-  GetSystemInfo(&sysinfo);
-  return sysinfo.dwNumberOfProcessors;
-#else
-  return get_nprocs();
-#endif
+    for (pos = 0; num_active > 0; pos++) {
+      for (i = 0; i < num_active; i++)
+	step_index_to_plaintext(&rc, indices[i], args->charset, args->plaintext_len_min, args->plaintext_len_max, plaintext_space_up_to_index, plaintexts + (i * MAX_PLAINTEXT_LEN), &(plaintext_lens[i]));
+
+      rc.hp->hash_many(plaintexts, plaintext_lens, num_active, hashes);
+
+      /* Compare each chain against the hash, and compact the still-active chains to
+       * the front of the batch. */
+      for (i = 0, j = 0; i < num_active; i++) {
+	candidate = lanes[i];
+	index = step_hash_to_index(&rc, hashes + (i * MAX_HASH_OUTPUT_LEN), args->reduction_offset, pos);
+	hash_base_index = args->hash_base_indices[candidate] % plaintext_space_total;
+
+	if ((index == (hash_base_index + pos)) || (index == (hash_base_index + pos - plaintext_space_total)))
+	  cpu_args->output[candidate] = indices[i];
+	else if (pos < args->potential_start_index_positions[candidate]) {
+	  lanes[j] = candidate;
+	  indices[j] = index;
+	  j++;
+	}
+      }
+      num_active = j;
+    }
+  }
+
+  return NULL;
 }
 
 
-/* A host thread which controls each GPU for false alarm checks. */
+/* A host thread which controls each GPU for false alarm checks.  This device checks
+ * every total_devices'th potential start index, starting from the end of the list
+ * (where the longest chains are, after check_false_alarms() sorts them).  They are
+ * uploaded in chunks, so the device buffers stay small and no single kernel run is
+ * long enough to trip a display driver's watchdog.  Two sets of buffers are used: the
+ * next chunk is queued up while the results of the previous one are checked, and
+ * any hashes cracked in it are reported right away. */
 void *host_thread_false_alarm(void *ptr) {
   thread_args *args = (thread_args *)ptr;
   gpu_dev *gpu = &(args->gpu);
@@ -636,111 +1178,79 @@ void *host_thread_false_alarm(void *ptr) {
   cl_kernel kernel = NULL;
   int err = 0;
   char *kernel_path = FALSE_ALARM_KERNEL_PATH, *kernel_name = "false_alarm_check";
+  char table_build_options[1536] = {0};
 
-  cl_mem hash_type_buffer = NULL, charset_buffer = NULL, plaintext_len_min_buffer = NULL, plaintext_len_max_buffer = NULL, reduction_offset_buffer = NULL, plaintext_space_total_buffer = NULL, plaintext_space_up_to_index_buffer = NULL, device_num_buffer = NULL, total_devices_buffer = NULL, num_start_indices_buffer = NULL, start_indices_buffer = NULL, start_index_positions_buffer = NULL, hash_base_indices_buffer = NULL, output_block_buffer = NULL, exec_block_scaler_buffer = NULL;
-  /*cl_mem debug_ulong_buffer = NULL;*/
+  cl_mem hash_type_buffer = NULL, charset_buffer = NULL, plaintext_len_min_buffer = NULL, plaintext_len_max_buffer = NULL, reduction_offset_buffer = NULL, plaintext_space_total_buffer = NULL, plaintext_space_up_to_index_buffer = NULL;
+  cl_mem num_start_indices_buffer[2] = {NULL}, start_indices_buffer[2] = {NULL}, start_index_positions_buffer[2] = {NULL}, hash_base_indices_buffer[2] = {NULL}, output_buffer[2] = {NULL};
+  cl_event output_read[2] = {NULL};
 
-  cl_ulong *start_indices = NULL, *hash_base_indices = NULL, *plaintext_indices = NULL, *output_block = NULL;
-  unsigned int *start_index_positions = NULL;
+  cl_ulong *start_indices[2] = {NULL}, *hash_base_indices[2] = {NULL}, *output[2] = {NULL};
+  unsigned int *start_index_positions[2] = {NULL};
+  cl_uint chunk_first[2] = {0}, chunk_len[2] = {0};
 
-  unsigned int num_start_indices = 0, num_start_index_positions = 0, num_hash_base_indices = 0, num_plaintext_indices = 0, num_exec_blocks = 0, output_block_len = 0, exec_block = 0, output_block_index = 0, plaintext_indicies_index = 0;
+  unsigned int num_start_indices = args->num_potential_start_indices, total_devices = args->total_devices, device_share = 0, num_chunks = 0, chunk = 0, slot = 0, candidate = 0, i = 0;
   uint64_t plaintext_space_total = 0;
   cl_ulong plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
-  size_t gws = 0, kernel_work_group_size = 0, kernel_preferred_work_group_size_multiple = 0;
-  /*cl_ulong debug_ulong[128] = {0};*/
+  size_t chunk_size = GPU_FALSE_ALARM_CHUNK_CANDIDATES, gws = 0;
 
 
+  args->results = NULL;
+  args->num_results = 0;
   plaintext_space_total = fill_plaintext_space_table(strlen(args->charset), args->plaintext_len_min, args->plaintext_len_max, plaintext_space_up_to_index);
 
-  num_start_indices = num_start_index_positions = num_hash_base_indices = num_plaintext_indices = args->num_potential_start_indices;
-
-  start_indices = args->potential_start_indices;
-  start_index_positions = args->potential_start_index_positions;
-  hash_base_indices = args->hash_base_indices;
-
-  plaintext_indices = calloc(num_plaintext_indices, sizeof(cl_ulong));
-  if (plaintext_indices == NULL) {
-    fprintf(stderr, "Error while allocating buffers.\n");
-    exit(-1);
-  }
-
-  /* If we're generating the standard NTLM 8-character tables, use the special
-   * optimized kernel instead! */
+  /* For the standard NTLM 8- and 9-character tables, the kernel is built with the
+   * optimized functions (see get_table_build_options()). */
   if (is_ntlm8(args->hash_type, args->charset, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, args->chain_len)) {
-    kernel_path = FALSE_ALARM_NTLM8_KERNEL_PATH;
-    kernel_name = "false_alarm_check_ntlm8";
     if ((args->gpu.device_number == 0) && (printed_false_alarm_optimized_message == 0)) { /* Only the first thread prints this, and only prints it once. */
       printf("\nNote: optimized NTLM8 kernel will be used for false alarm checks.\n\n"); fflush(stdout);
       printed_false_alarm_optimized_message = 1;
     }
   } else if (is_ntlm9(args->hash_type, args->charset, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, args->chain_len)) {
-    kernel_path = FALSE_ALARM_NTLM9_KERNEL_PATH;
-    kernel_name = "false_alarm_check_ntlm9";
     if ((args->gpu.device_number == 0) && (printed_false_alarm_optimized_message == 0)) { /* Only the first thread prints this, and only prints it once. */
       printf("\nNote: optimized NTLM9 kernel will be used for false alarm checks.\n\n"); fflush(stdout);
       printed_false_alarm_optimized_message = 1;
     }
   }
 
-  /* Load the kernel. */
-  gpu->context = CLCREATECONTEXT(context_callback, &(gpu->device));
-  gpu->queue = CLCREATEQUEUE(gpu->context, gpu->device);
-  load_kernel(gpu->context, 1, &(gpu->device), kernel_path, kernel_name, &(gpu->program), &(gpu->kernel), args->hash_type);
+  /* Get the kernel (it is only built the first time). */
+  get_table_build_options(table_build_options, sizeof(table_build_options), args->hash_type, args->charset, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, args->chain_len);
+  gpu_session_get_kernel(&(gpu_sessions[gpu->device_number]), kernel_path, kernel_name, args->hash_type, table_build_options, &(gpu->context), &(gpu->program), &(gpu->kernel), &(gpu->queue));
 
   /* These variables are set so the CLCREATEARG* macros work correctly. */
   context = gpu->context;
   queue = gpu->queue;
   kernel = gpu->kernel;
 
-  if ((rc_clGetKernelWorkGroupInfo(kernel, gpu->device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &kernel_work_group_size, NULL) != CL_SUCCESS) || \
-      (rc_clGetKernelWorkGroupInfo(kernel, gpu->device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof(size_t), &kernel_preferred_work_group_size_multiple, NULL) != CL_SUCCESS)) {
-    fprintf(stderr, "Failed to get preferred work group size!\n");
-    CLRELEASEKERNEL(gpu->kernel);
-    CLRELEASEPROGRAM(gpu->program);
-    CLRELEASEQUEUE(gpu->queue);
-    CLRELEASECONTEXT(gpu->context);
-    pthread_exit(NULL);
-    return NULL;
-  }
-
-  /* If the user provided a static GWS on the command line, use that.   Otherwise,
-   * use the driver's work group size multiplied by the preferred multiple. */
+  /* If the user provided a static GWS on the command line, use that as the chunk
+   * size.  Every device must use the same one, since on AMD GPUs they all wait on the
+   * barrier before each chunk. */
   if (user_provided_gws > 0) {
-    gws = user_provided_gws;
-    printf("GPU #%u is using user-provided GWS value of %"PRIu64"\n", gpu->device_number, gws);
-  } else {
-    /*gws = kernel_work_group_size * kernel_preferred_work_group_size_multiple;*/
-
-    /* TODO: fix this so that false alarm checking is done in partitions instead of
-     * all at once (this can improve speed).  Currently, when GWS != num_start_indices,
-     * lookups don't succeed due to some bug. */
-    gws = num_start_indices;
-
-    /* Somehow, on AMD GPUs, the kernel crashes with a message like:
-     *
-     *   Memory access fault by GPU node-2 (Agent handle: 0x1bb5e00) on address
-     *   0x7f4c80b27000. Reason: Page not present or supervisor privilege.
-     *
-     * A work-around is to set the GWS to the number of start indices and just do it in
-     * one pass. */
-    if (is_amd_gpu)
-      gws = num_start_indices;
-
-    /*printf("GPU #%u is using dynamic GWS: %"PRIu64" (work group) x %"PRIu64" (pref. multiple) = %"PRIu64"\n", gpu->device_number, kernel_work_group_size, kernel_preferred_work_group_size_multiple, gws);*/
+    chunk_size = user_provided_gws;
+    printf("GPU #%u is using user-provided GWS value of %zu\n", gpu->device_number, chunk_size);
   }
   fflush(stdout);
 
+  /* The first devices may get one more potential start index than the others; the
+   * chunk count is based on the largest share so that all devices agree on it. */
+  if (num_start_indices > gpu->device_number)
+    device_share = ((num_start_indices - gpu->device_number - 1) / total_devices) + 1;
+  num_chunks = ((num_start_indices + total_devices - 1) / total_devices + chunk_size - 1) / chunk_size;
+
+  for (slot = 0; slot < 2; slot++) {
+    start_indices[slot] = calloc(chunk_size, sizeof(cl_ulong));
+    start_index_positions[slot] = calloc(chunk_size, sizeof(unsigned int));
+    hash_base_indices[slot] = calloc(chunk_size, sizeof(cl_ulong));
+    output[slot] = calloc(chunk_size, sizeof(cl_ulong));
+    if ((start_indices[slot] == NULL) || (start_index_positions[slot] == NULL) || (hash_base_indices[slot] == NULL) || (output[slot] == NULL)) {
+      fprintf(stderr, "Error while allocating false alarm buffers.\n");
+      exit(-1);
+    }
 
-  /* Count the number of times we need to run the kernel. */
-  num_exec_blocks = num_start_indices / gws;
-  if (num_start_indices % gws != 0)
-    num_exec_blocks++;
-
-  output_block_len = gws;
-  output_block = calloc(output_block_len, sizeof(cl_ulong));
-  if (output_block == NULL) {
-    fprintf(stderr, "Error while allocating output buffer(s).\n");
-    exit(-1);
+    CLCREATEBUFFER(num_start_indices_buffer[slot], CL_RO, sizeof(cl_uint));
+    CLCREATEBUFFER(start_indices_buffer[slot], CL_RO, chunk_size * sizeof(cl_ulong));
+    CLCREATEBUFFER(start_index_positions_buffer[slot], CL_RO, chunk_size * sizeof(unsigned int));
+    CLCREATEBUFFER(hash_base_indices_buffer[slot], CL_RO, chunk_size * sizeof(cl_ulong));
+    CLCREATEBUFFER(output_buffer[slot], CL_WO, chunk_size * sizeof(cl_ulong));
   }
 
   CLCREATEARG(0, hash_type_buffer, CL_RO, args->hash_type, sizeof(cl_uint));
@@ -750,59 +1260,75 @@ void *host_thread_false_alarm(void *ptr) {
   CLCREATEARG(4, reduction_offset_buffer, CL_RO, args->reduction_offset, sizeof(cl_uint));
   CLCREATEARG(5, plaintext_space_total_buffer, CL_RO, plaintext_space_total, sizeof(cl_ulong));
   CLCREATEARG_ARRAY(6, plaintext_space_up_to_index_buffer, CL_RO, plaintext_space_up_to_index, MAX_PLAINTEXT_LEN * sizeof(cl_ulong));
-  CLCREATEARG(7, device_num_buffer, CL_RO, gpu->device_number, sizeof(cl_uint));
-  CLCREATEARG(8, total_devices_buffer, CL_RO, args->total_devices, sizeof(cl_uint));
-  CLCREATEARG(9, num_start_indices_buffer, CL_RO, num_start_indices, sizeof(cl_uint));
-  CLCREATEARG_ARRAY(10, start_indices_buffer, CL_RO, start_indices, num_start_indices * sizeof(cl_ulong));
-  CLCREATEARG_ARRAY(11, start_index_positions_buffer, CL_RO, start_index_positions, num_start_index_positions * sizeof(unsigned int));
-  CLCREATEARG_ARRAY(12, hash_base_indices_buffer, CL_RO, hash_base_indices, num_hash_base_indices * sizeof(cl_ulong));
-  CLCREATEARG_ARRAY(14, output_block_buffer, CL_WO, output_block, output_block_len * sizeof(cl_ulong));
 
-  for (exec_block = 0; exec_block < num_exec_blocks; exec_block++) {
-    unsigned int exec_block_scaler = exec_block * gws;
+  /* One extra pass is made to collect the results of the last chunk. */
+  for (chunk = 0; chunk <= num_chunks; chunk++) {
+    slot = chunk % 2;
+
+    if (chunk < num_chunks) {
+      chunk_first[slot] = chunk * chunk_size;
+      chunk_len[slot] = 0;
+      if (chunk_first[slot] < device_share)
+	chunk_len[slot] = ((device_share - chunk_first[slot]) > chunk_size) ? chunk_size : (device_share - chunk_first[slot]);
+
+      for (i = 0; i < chunk_len[slot]; i++) {
+	candidate = num_start_indices - gpu->device_number - ((chunk_first[slot] + i) * total_devices) - 1;
+	start_indices[slot][i] = args->potential_start_indices[candidate];
+	start_index_positions[slot][i] = args->potential_start_index_positions[candidate];
+	hash_base_indices[slot][i] = args->hash_base_indices[candidate];
+      }
 
-    CLCREATEARG(13, exec_block_scaler_buffer, CL_RO, exec_block_scaler, sizeof(cl_uint));
+      if (is_amd_gpu) {
+	int barrier_ret = pthread_barrier_wait(&barrier);
+	if ((barrier_ret != 0) && (barrier_ret != PTHREAD_BARRIER_SERIAL_THREAD)) {
+	  fprintf(stderr, "pthread_barrier_wait() failed!\n"); fflush(stderr);
+	  exit(-1);
+	}
+      }
 
-    if (is_amd_gpu) {
-      int barrier_ret = pthread_barrier_wait(&barrier);
-      if ((barrier_ret != 0) && (barrier_ret != PTHREAD_BARRIER_SERIAL_THREAD)) {
-	fprintf(stderr, "pthread_barrier_wait() failed!\n"); fflush(stderr);
-	exit(-1);
+      /* Queue up this chunk's upload, run, and download without waiting on any of
+       * them.  The kernel arguments are captured when the kernel is queued, so the
+       * other set of buffers can be switched in for the next chunk right away. */
+      if (chunk_len[slot] > 0) {
+	CLWRITEBUFFERASYNC(num_start_indices_buffer[slot], sizeof(cl_uint), &(chunk_len[slot]));
+	CLWRITEBUFFERASYNC(start_indices_buffer[slot], chunk_len[slot] * sizeof(cl_ulong), start_indices[slot]);
+	CLWRITEBUFFERASYNC(start_index_positions_buffer[slot], chunk_len[slot] * sizeof(unsigned int), start_index_positions[slot]);
+	CLWRITEBUFFERASYNC(hash_base_indices_buffer[slot], chunk_len[slot] * sizeof(cl_ulong), hash_base_indices[slot]);
+	CLSETARG(7, num_start_indices_buffer[slot]);
+	CLSETARG(8, start_indices_buffer[slot]);
+	CLSETARG(9, start_index_positions_buffer[slot]);
+	CLSETARG(10, hash_base_indices_buffer[slot]);
+	CLSETARG(11, output_buffer[slot]);
+
+	gws = chunk_len[slot];
+	CLRUNKERNEL(gpu->queue, gpu->kernel, &gws);
+	CLREADBUFFERASYNC(output_buffer[slot], chunk_len[slot] * sizeof(cl_ulong), output[slot], &(output_read[slot]));
+	CLFLUSH(gpu->queue);
       }
     }
 
-    /* Run the kernel and wait for it to finish. */
-    CLRUNKERNEL(gpu->queue, gpu->kernel, &gws);
-    CLFLUSH(gpu->queue);
-    CLWAIT(gpu->queue);
+    /* While that chunk runs, check the results of the one before it. */
+    if (chunk > 0) {
+      slot = (chunk - 1) % 2;
+      if (output_read[slot] != NULL) {
+	CLWAITEVENT(output_read[slot]);
 
-    /* Read the results. */
-    CLREADBUFFER(output_block_buffer, output_block_len * sizeof(cl_ulong), output_block);
-
-    output_block_index = 0;
-    while ((plaintext_indicies_index < num_plaintext_indices) && (output_block_index < output_block_len))
-      plaintext_indices[plaintext_indicies_index++] = output_block[output_block_index++];
-
-    CLFREEBUFFER(exec_block_scaler_buffer);
+	for (i = 0; i < chunk_len[slot]; i++) {
+	  if (output[slot][i] != 0) {
+	    candidate = num_start_indices - gpu->device_number - ((chunk_first[slot] + i) * total_devices) - 1;
+	    check_false_alarm_result(args, args->ppi_refs[candidate], output[slot][i]);
+	  }
+	}
+      }
+    }
   }
 
-  /* Set the results so the main thread can access them. */
-  args->results = plaintext_indices;
-  args->num_results = num_plaintext_indices;
-
-  /*
-  {
-    unsigned int i = 0;
-
-    printf("results: ");
-    for (i = 0; i < args->num_results; i++)
-      printf("%lu ", args->results[i]);
-
-    printf("\n");
+  /* If the loop was left early, a chunk's results may still be on their way back.  They
+   * must land before the buffers are freed. */
+  for (slot = 0; slot < 2; slot++) {
+    if (output_read[slot] != NULL)
+      CLWAITEVENT(output_read[slot]);
   }
-  */
-
-  FREE(output_block);
 
   CLFREEBUFFER(hash_type_buffer);
   CLFREEBUFFER(charset_buffer);
@@ -811,20 +1337,20 @@ void *host_thread_false_alarm(void *ptr) {
   CLFREEBUFFER(reduction_offset_buffer);
   CLFREEBUFFER(plaintext_space_total_buffer);
   CLFREEBUFFER(plaintext_space_up_to_index_buffer);
-  CLFREEBUFFER(device_num_buffer);
-  CLFREEBUFFER(total_devices_buffer);
-  CLFREEBUFFER(num_start_indices_buffer);
-  CLFREEBUFFER(start_indices_buffer);
-  CLFREEBUFFER(start_index_positions_buffer);
-  CLFREEBUFFER(hash_base_indices_buffer);
-  CLFREEBUFFER(output_block_buffer);
 
-  CLRELEASEKERNEL(gpu->kernel);
-  CLRELEASEPROGRAM(gpu->program);
-  CLRELEASEQUEUE(gpu->queue);
-  CLRELEASECONTEXT(gpu->context);
+  for (slot = 0; slot < 2; slot++) {
+    CLFREEBUFFER(num_start_indices_buffer[slot]);
+    CLFREEBUFFER(start_indices_buffer[slot]);
+    CLFREEBUFFER(start_index_positions_buffer[slot]);
+    CLFREEBUFFER(hash_base_indices_buffer[slot]);
+    CLFREEBUFFER(output_buffer[slot]);
+
+    FREE(start_indices[slot]);
+    FREE(start_index_positions[slot]);
+    FREE(hash_base_indices[slot]);
+    FREE(output[slot]);
+  }
 
-  pthread_exit(NULL);
   return NULL;
 }
 
@@ -838,6 +1364,7 @@ void *host_thread_precompute(void *ptr) {
   cl_kernel kernel = NULL;
   int err = 0;
   char *kernel_path = PRECOMPUTE_KERNEL_PATH, *kernel_name = "precompute";
+  char table_build_options[1536] = {0};
 
   cl_mem hash_type_buffer = NULL, hash_buffer = NULL, hash_len_buffer = NULL, charset_buffer = NULL, plaintext_len_min_buffer = NULL, plaintext_len_max_buffer = NULL, table_index_buffer = NULL, chain_len_buffer = NULL, device_num_buffer = NULL, total_devices_buffer = NULL, exec_block_scaler_buffer = NULL, output_block_buffer = NULL/*, debug_buffer = NULL*/;
 
@@ -860,28 +1387,23 @@ void *host_thread_precompute(void *ptr) {
   if ((args->chain_len % args->total_devices) != 0)
     output_len++;
 
-  /* If we're generating the standard NTLM 8-character tables, use the special
-   * optimized kernel instead! */
+  /* For the standard NTLM 8- and 9-character tables, the kernel is built with the
+   * optimized functions (see get_table_build_options()). */
   if (is_ntlm8(args->hash_type, args->charset, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, args->chain_len)) {
-    kernel_path = PRECOMPUTE_NTLM8_KERNEL_PATH;
-    kernel_name = "precompute_ntlm8";
     if ((args->gpu.device_number == 0) && (printed_precompute_optimized_message == 0)) { /* Only the first thread prints this, and only prints it once. */
       printf("\nNote: optimized NTLM8 kernel will be used for precomputation.\n\n"); fflush(stdout);
       printed_precompute_optimized_message = 1;
     }
   } else if (is_ntlm9(args->hash_type, args->charset, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, args->chain_len)) {
-    kernel_path = PRECOMPUTE_NTLM9_KERNEL_PATH;
-    kernel_name = "precompute_ntlm9";
     if ((args->gpu.device_number == 0) && (printed_precompute_optimized_message == 0)) { /* Only the first thread prints this, and only prints it once. */
       printf("\nNote: optimized NTLM9 kernel will be used for precomputation.\n\n"); fflush(stdout);
       printed_precompute_optimized_message = 1;
     }
   }
 
-  /* Load the kernel. */
-  gpu->context = CLCREATECONTEXT(context_callback, &(gpu->device));
-  gpu->queue = CLCREATEQUEUE(gpu->context, gpu->device);
-  load_kernel(gpu->context, 1, &(gpu->device), kernel_path, kernel_name, &(gpu->program), &(gpu->kernel), args->hash_type);
+  /* Get the kernel (it is only built the first time). */
+  get_table_build_options(table_build_options, sizeof(table_build_options), args->hash_type, args->charset, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, args->chain_len);
+  gpu_session_get_kernel(&(gpu_sessions[gpu->device_number]), kernel_path, kernel_name, args->hash_type, table_build_options, &(gpu->context), &(gpu->program), &(gpu->kernel), &(gpu->queue));
 
   /* These variables are set so the CLCREATEARG* macros work correctly. */
   context = gpu->context;
@@ -890,10 +1412,6 @@ void *host_thread_precompute(void *ptr) {
 
   if (rc_clGetKernelWorkGroupInfo(kernel, gpu->device, CL_KERNEL_WORK_GROUP_SIZE /*CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE*/, sizeof(size_t), &gws, NULL) != CL_SUCCESS) {
     fprintf(stderr, "Failed to get preferred work group size!\n");
-    CLRELEASEKERNEL(gpu->kernel);
-    CLRELEASEPROGRAM(gpu->program);
-    CLRELEASEQUEUE(gpu->queue);
-    CLRELEASECONTEXT(gpu->context);
     pthread_exit(NULL);
     return NULL;
   }
@@ -997,119 +1515,233 @@ void *host_thread_precompute(void *ptr) {
   CLFREEBUFFER(output_block_buffer);
   /*CLFREEBUFFER(debug_buffer);*/
 
-  CLRELEASEKERNEL(gpu->kernel);
-  CLRELEASEPROGRAM(gpu->program);
-  CLRELEASEQUEUE(gpu->queue);
-  CLRELEASECONTEXT(gpu->context);
+  pthread_exit(NULL);
+  return NULL;
+}
+
+
+/* A CPU thread which computes the end indices for a subset of the chain positions of
+ * one hash.  The work for position i is (chain_len - i - 2) hash/reduce steps, so the
+ * positions are split into batches of CHAIN_BATCH_SIZE that are paired from opposite
+ * ends (the first with the last, the second with the second-to-last, etc.).  Each pair
+ * costs roughly the same, so dealing the pairs out round-robin evenly balances the
+ * triangle of work across all threads. */
+void *cpu_thread_precompute(void *ptr) {
+  cpu_thread_args *cpu_args = (cpu_thread_args *)ptr;
+  thread_args *args = cpu_args->args;
+  uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
+  uint64_t indices[CHAIN_BATCH_SIZE] = {0};
+  unsigned char hash[MAX_HASH_OUTPUT_LEN] = {0};
+  unsigned int charset_len = strlen(args->charset), hash_len = 0, num_positions = args->chain_len - 1;
+  unsigned int num_batches = 0, num_pairs = 0, pair = 0, batch = 0, batch_start = 0, batch_len = 0, last_pos = 0, i = 0, j = 0;
+  uint64_t plaintext_space_total = fill_plaintext_space_table(charset_len, args->plaintext_len_min, args->plaintext_len_max, plaintext_space_up_to_index);
+
+
+  hash_len = hex_to_bytes(args->hash, sizeof(hash), hash);
+
+  num_batches = (num_positions + CHAIN_BATCH_SIZE - 1) / CHAIN_BATCH_SIZE;
+  num_pairs = (num_batches + 1) / 2;
+  for (pair = cpu_args->thread_number; pair < num_pairs; pair += cpu_args->total_threads) {
+    for (j = 0; j < 2; j++) {
+      batch = (j == 0) ? pair : (num_batches - pair - 1);
+
+      /* With an odd number of batches, the middle one pairs with itself. */
+      if ((j == 1) && (batch == pair))
+	break;
+
+      batch_start = batch * CHAIN_BATCH_SIZE;
+      batch_len = num_positions - batch_start;
+      if (batch_len > CHAIN_BATCH_SIZE)
+	batch_len = CHAIN_BATCH_SIZE;
+      last_pos = batch_start + batch_len - 1;
+
+      /* Each chain in the batch starts by reducing the hash at its own position.  Walk
+       * each one individually up to the last position in the batch so that they are
+       * all in step... */
+      for (i = 0; i < batch_len; i++) {
+	indices[i] = hash_to_index(hash, hash_len, args->reduction_offset, plaintext_space_total, batch_start + i);
+	generate_rainbow_chains(args->hash_type, args->charset, charset_len, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, batch_start + i + 1, last_pos + 2, &(indices[i]), 1, plaintext_space_up_to_index, plaintext_space_total);
+      }
+
+      /* ... then walk them all together to the end of the chain. */
+      generate_rainbow_chains(args->hash_type, args->charset, charset_len, args->plaintext_len_min, args->plaintext_len_max, args->reduction_offset, last_pos + 1, args->chain_len, indices, batch_len, plaintext_space_up_to_index, plaintext_space_total);
+
+      memcpy(cpu_args->output + batch_start, indices, batch_len * sizeof(uint64_t));
+    }
+  }
 
   pthread_exit(NULL);
   return NULL;
 }
 
 
-void precompute_hash(unsigned int num_devices, thread_args *args, precomputed_and_potential_indices **ppi_head) {
-  pthread_t threads[MAX_NUM_DEVICES] = {0};
-  char filename[128] = {0}, time_str[128] = {0}, index_data[256] = {0};
-  struct timespec start_time = {0};
-  unsigned int i = 0, j = 0, output_index = 0;
-  int k = 0;
+/* Runs the precomputation for one hash across all CPU cores, and returns the end
+ * indices for each chain position, in order.  The number of indices is stored in
+ * num_output. */
+uint64_t *precompute_hash_cpu(thread_args *args, unsigned int *num_output) {
+  pthread_t *threads = NULL;
+  cpu_thread_args *cpu_args = NULL;
+  unsigned int num_threads = get_num_cpu_cores(), i = 0;
   uint64_t *output = NULL;
-  FILE *f = NULL;
-  precomputed_and_potential_indices *ppi = NULL;
 
 
-  /* Set the index data we're looking for (or will create later). */
-  snprintf(index_data, sizeof(index_data) - 1, "%s_%s#%d-%d_%d_%d:%s\n", args->hash_name, args->charset_name, args->plaintext_len_min, args->plaintext_len_max, args->table_index, args->chain_len, args->hash); /*ntlm_loweralpha#8-8_0_100:49e5bfaab1be72a6c5236f15736a3e15*/
-
-  /* Search through the cache and see if we already precomputed the indices for this
-   * hash. */
-  output = search_precompute_cache(index_data, &output_index, filename, sizeof(filename));
+  output = calloc(args->chain_len - 1, sizeof(uint64_t));
+  threads = calloc(num_threads, sizeof(pthread_t));
+  cpu_args = calloc(num_threads, sizeof(cpu_thread_args));
+  if ((output == NULL) || (threads == NULL) || (cpu_args == NULL)) {
+    fprintf(stderr, "Error allocating buffers for CPU precomputation.\n");
+    exit(-1);
+  }
 
-  /* Cache miss... */
-  if (output == NULL) {
-  
-    /* Start the timer for this hash. */
-    start_timer(&start_time);
+  for (i = 0; i < num_threads; i++) {
+    cpu_args[i].args = args;
+    cpu_args[i].output = output;
+    cpu_args[i].thread_number = i;
+    cpu_args[i].total_threads = num_threads;
 
-    /* Start one thread to control each GPU. */
-    for (i = 0; i < num_devices; i++) {
-      if (pthread_create(&(threads[i]), NULL, &host_thread_precompute, &(args[i]))) {
-	perror("Failed to create thread");
-	exit(-1);
-      }
+    if (pthread_create(&(threads[i]), NULL, &cpu_thread_precompute, &(cpu_args[i]))) {
+      perror("Failed to create thread");
+      exit(-1);
     }
+  }
 
-    /* Wait for all threads to finish. */
-    for (i = 0; i < num_devices; i++) {
-      if (pthread_join(threads[i], NULL) != 0) {
-	perror("Failed to join with thread");
-	exit(-1);
-      }
+  /* Wait for all threads to finish. */
+  for (i = 0; i < num_threads; i++) {
+    if (pthread_join(threads[i], NULL) != 0) {
+      perror("Failed to join with thread");
+      exit(-1);
     }
+  }
 
-    num_hashes_precomputed++;
+  FREE(threads);
+  FREE(cpu_args);
+
+  *num_output = args->chain_len - 1;
+  return output;
+}
 
-    seconds_to_human_time(time_str, sizeof(time_str), get_elapsed(&start_time));
-    printf("  Completed in %s.\n", time_str);  fflush(stdout);
-    print_eta_precompute();
 
-    /* Create one output array to hold all the results. */
-    output = calloc(args[0].num_results * num_devices, sizeof(uint64_t));
-    if (output == NULL) {
-      fprintf(stderr, "Error allocating buffer for GPU results.\n");
+/* Runs the precomputation for one hash across all GPUs, and returns the end indices
+ * for each chain position, in order.  The number of indices is stored in
+ * num_output. */
+uint64_t *precompute_hash_gpu(unsigned int num_devices, thread_args *args, unsigned int *num_output) {
+  pthread_t threads[MAX_NUM_DEVICES] = {0};
+  unsigned int i = 0, j = 0, output_index = 0;
+  uint64_t *output = NULL;
+
+
+  /* Start one thread to control each GPU. */
+  for (i = 0; i < num_devices; i++) {
+    if (pthread_create(&(threads[i]), NULL, &host_thread_precompute, &(args[i]))) {
+      perror("Failed to create thread");
+      exit(-1);
+    }
+  }
+
+  /* Wait for all threads to finish. */
+  for (i = 0; i < num_devices; i++) {
+    if (pthread_join(threads[i], NULL) != 0) {
+      perror("Failed to join with thread");
       exit(-1);
     }
+  }
 
-    /*
-      The results end up spread out like this across many GPUs:
+  /* Create one output array to hold all the results. */
+  output = calloc(args[0].num_results * num_devices, sizeof(uint64_t));
+  if (output == NULL) {
+    fprintf(stderr, "Error allocating buffer for GPU results.\n");
+    exit(-1);
+  }
 
-      GPU 0: 100 94 88 82 76 70 64 58 52 46 40 34 28 22 16 10 4 
-      GPU 1: 99 93 87 81 75 69 63 57 51 45 39 33 27 21 15 9 3 
-      GPU 2: 98 92 86 80 74 68 62 56 50 44 38 32 26 20 14 8 2 
-      GPU 3: 97 91 85 79 73 67 61 55 49 43 37 31 25 19 13 7 1 
-      GPU 4: 96 90 84 78 72 66 60 54 48 42 36 30 24 18 12 6 0 
-      GPU 5: 95 89 83 77 71 65 59 53 47 41 35 29 23 17 11 5 0 
+  /*
+    The results end up spread out like this across many GPUs:
 
-      Below, we collate the results into a single array containing "100 99 98 [...]".
-    */
-    for (i = 0; i < args[0].num_results; i++) {
-      for (j = 0; j < num_devices; j++) {
-	output[output_index] = args[j].results[i];
-	output_index++;
-      }
-    }
+    GPU 0: 100 94 88 82 76 70 64 58 52 46 40 34 28 22 16 10 4 
+    GPU 1: 99 93 87 81 75 69 63 57 51 45 39 33 27 21 15 9 3 
+    GPU 2: 98 92 86 80 74 68 62 56 50 44 38 32 26 20 14 8 2 
+    GPU 3: 97 91 85 79 73 67 61 55 49 43 37 31 25 19 13 7 1 
+    GPU 4: 96 90 84 78 72 66 60 54 48 42 36 30 24 18 12 6 0 
+    GPU 5: 95 89 83 77 71 65 59 53 47 41 35 29 23 17 11 5 0 
 
-    /* Now that pulled all the GPU results into one array, free them. */
-    for (i = 0; i < num_devices; i++) {
-      FREE(args[i].results);
-      args[i].num_results = 0;
+    Below, we collate the results into a single array containing "100 99 98 [...]".
+  */
+  for (i = 0; i < args[0].num_results; i++) {
+    for (j = 0; j < num_devices; j++) {
+      output[output_index] = args[j].results[i];
+      output_index++;
     }
+  }
+
+  /* Now that pulled all the GPU results into one array, free them. */
+  for (i = 0; i < num_devices; i++) {
+    FREE(args[i].results);
+    args[i].num_results = 0;
+  }
+
+  /* We may have a few extra indices in the array at the end, if the chain length
+   * is not divisible by the number of GPUs.  In that case, we simply truncate the
+   * end of the array. */
+  if (output_index >= args[0].chain_len - 1)
+    output_index = args[0].chain_len -1;
+  else { /* Sanity check: this should never happen... */
+    fprintf(stderr, "Error: output_index < chain_len - 1!: %u < %u\n", output_index, args[0].chain_len - 1);
+    exit(-1);
+  }
 
-    /* We may have a few extra indices in the array at the end, if the chain length
-     * is not divisible by the number of GPUs.  In that case, we simply truncate the
-     * end of the array. */
-    if (output_index >= args[0].chain_len - 1)
-      output_index = args[0].chain_len -1;
-    else { /* Sanity check: this should never happen... */
-      fprintf(stderr, "Error: output_index < chain_len - 1!: %u < %u\n", output_index, args[0].chain_len - 1);
+  /* Reverse the output buffer.
+   * TODO: this logic can be merged in, above, to simplify. */
+  {
+    uint64_t *tmp = calloc(output_index, sizeof(uint64_t));
+    if (tmp == NULL) {
+      fprintf(stderr, "Failed to create temp buffer.\n");
       exit(-1);
     }
 
-    /* Reverse the output buffer.
-     * TODO: this logic can be merged in, above, to simplify. */
-    {
-      uint64_t *tmp = calloc(output_index, sizeof(uint64_t));
-      if (tmp == NULL) {
-	fprintf(stderr, "Failed to create temp buffer.\n");
-	exit(-1);
-      }
+    for (i = 0; i < output_index; i++)
+      tmp[i] = output[output_index - i - 1];
+
+    FREE(output);
+    output = tmp;
+  }
+
+  *num_output = output_index;
+  return output;
+}
+
+
+void precompute_hash(unsigned int num_devices, thread_args *args, precomputed_and_potential_indices **ppi_head) {
+  char filename[128] = {0}, time_str[128] = {0}, index_data[256] = {0};
+  struct timespec start_time = {0};
+  unsigned int i = 0, output_index = 0;
+  int k = 0;
+  uint64_t *output = NULL;
+  FILE *f = NULL;
+  precomputed_and_potential_indices *ppi = NULL;
+
+
+  /* Set the index data we're looking for (or will create later). */
+  snprintf(index_data, sizeof(index_data) - 1, "%s_%s#%d-%d_%d_%d:%s\n", args->hash_name, args->charset_name, args->plaintext_len_min, args->plaintext_len_max, args->table_index, args->chain_len, args->hash); /*ntlm_loweralpha#8-8_0_100:49e5bfaab1be72a6c5236f15736a3e15*/
+
+  /* Search through the cache and see if we already precomputed the indices for this
+   * hash. */
+  output = search_precompute_cache(index_data, &output_index, filename, sizeof(filename));
+
+  /* Cache miss... */
+  if (output == NULL) {
+  
+    /* Start the timer for this hash. */
+    start_timer(&start_time);
 
-      for (i = 0; i < output_index; i++)
-	tmp[i] = output[output_index - i - 1];
+    if (use_cpu)
+      output = precompute_hash_cpu(args, &output_index);
+    else
+      output = precompute_hash_gpu(num_devices, args, &output_index);
 
-      FREE(output);
-      output = tmp;
-    }
+    num_hashes_precomputed++;
+
+    seconds_to_human_time(time_str, sizeof(time_str), get_elapsed(&start_time));
+    printf("  Completed in %s.\n", time_str);  fflush(stdout);
+    print_eta_precompute();
 
     /* Ensure we didn't get all zeros. */
     for (k = 0; k < output_index; k++)
@@ -1317,10 +1949,12 @@ void _preloading_thread(char *rt_dir) {
 	    exit(-1);
 	  }
 
-	  /* Set the file path, rainbow table, and number of chains in the newest entry of the preload list. */
+	  /* Set the file path in the newest entry of the preload list, and build the
+	   * search structure for the table's end indices (this takes ownership of
+	   * rainbow_table). */
 	  pt->filepath = strdup(filepath);
-	  pt->rainbow_table = rainbow_table;
-	  pt->num_chains = num_chains;
+	  rt_search_table_init(&(pt->table), rainbow_table, num_chains);
+	  rainbow_table = NULL;
 
 	  /* Lock the preloading system, since we're modifying shared structures. */
 	  pthread_mutex_lock(&preloaded_tables_lock);
@@ -1427,106 +2061,590 @@ void print_usage_and_exit(char *prog_name, int exit_code) {
   char *dir2 = "/home/user/";
 #endif
 
-  fprintf(stderr, "%sUsage:%s %s rainbow_table_directory (single_hash | filename_with_many_hashes.txt) [-gws GWS] [-disable-platform N]\n\n", WHITEB, CLR, prog_name);
+  fprintf(stderr, "%sUsage:%s %s rainbow_table_directory (single_hash | filename_with_many_hashes.txt) [-gws GWS] [-disable-platform N] [-cpu] [-gpu-search]\n\n", WHITEB, CLR, prog_name);
   fprintf(stderr, "    %s-gws GWS%s    (Optional) Sets the global work size for each GPU.  This can significantly affect the speed.  To tune this setting, start with multiplying the max compute units by the max work group size (both are reported on program start-up).  Then increase/decrease the value and time the results.  For example, if the max compute units is 20, and the max work group size is 1024, try using 20 x 1024 = 20480, then 20480 - 1024 = 19456, 20480 - 2048 = 18432, 2048 + 1024 = 21504, etc.  If you find a value that works better than the automatic setting, please report your findings at: https://github.com/jtesta/rainbowcrackalack/issues\n\n", WHITEB, CLR);
-  fprintf(stderr, "    %s-disable-platform N%s    (Optional) Disables a platform from being used (platform numbers are reported on program start-up).  Useful when experiencing strange problems on mixed-GPU systems.  Try disabling each platform one at a time and see if the program behaves normally.\n\n\n", WHITEB, CLR);
+  fprintf(stderr, "    %s-disable-platform N%s    (Optional) Disables a platform from being used (platform numbers are reported on program start-up).  Useful when experiencing strange problems on mixed-GPU systems.  Try disabling each platform one at a time and see if the program behaves normally.\n\n", WHITEB, CLR);
+  fprintf(stderr, "    %s-cpu%s    (Optional) Performs the pre-computation and false alarm checks on all CPU cores (using AVX2/AVX-512 when available) instead of on GPUs.  Useful on machines without OpenCL devices.  Even without this option, false alarm checks are done on the CPU when there are only a few of them.\n\n", WHITEB, CLR);
+  fprintf(stderr, "    %s-gpu-search%s    (Optional) Searches the tables on the GPUs instead of on the CPU.  The pre-computed end indices of all hashes are kept in GPU memory (16 bytes each), and each table is sent to the GPUs as it is searched.  Ignored when -cpu is given.\n\n\n", WHITEB, CLR);
   fprintf(stderr, "%sExamples:%s\n    %s %s 64f12cddaa88057e06a81b54e73b949b\n    %s %s %shashes_one_per_line.txt\n    %s %s %spwdump.txt\n\n", WHITEB, CLR, prog_name, dir1, prog_name, dir1, dir2, prog_name, dir1, dir2);
   exit(exit_code);
 }
 
 
-/* Helper function for rt_binary_search(). */
-unsigned int _rt_binary_search(cl_ulong *rainbow_table, unsigned int low, unsigned int high, cl_ulong search_index, cl_ulong *start) {
-  unsigned int chain = 0;
+/* Adds a match that a search method found to a search thread's hit buffer (see
+ * rt_search_hit_func in rt_search.h). */
+void add_numbered_search_hit(void *ctx, unsigned int hash_number, unsigned int position, uint64_t start_index) {
+  add_search_hit((hit_buffer *)ctx, numbered_hashes[hash_number], start_index, position);
+}
+
 
+/* Returns the next chunk of the current table search, or NULL if none are left. */
+search_chunk *get_search_chunk() {
+  unsigned int chunk = __atomic_fetch_add(&next_search_chunk, 1, __ATOMIC_RELAXED);
 
-  /*printf("_rt_binary_search(%u, %u, %lu)\n", low, high, search_index);*/
-  if (high - low <= 8) {
-    for (chain = low; chain < high; chain++) {
-      if (search_index == rainbow_table[(chain * 2) + 1]) {
-	*start = rainbow_table[chain * 2];
-	/*printf("\nbinary search: found %lu at %u (between %u and %u)\n", *start, chain, low, high);*/
-	return 1;
-      }
-    }
-  } else {
-    chain = ((high - low) / 2) + low;
-    if (search_index >= rainbow_table[(chain * 2) + 1])
-      return _rt_binary_search(rainbow_table, chain, high, search_index, start);
-    else
-      return _rt_binary_search(rainbow_table, low, chain, search_index, start);
-  }
 
-  return 0;
+  return (chunk < num_search_chunks) ? &(search_chunks[chunk]) : NULL;
 }
 
 
+/* A thread which searches a table for chunks of the uncracked hashes' precomputed end
+ * indices.  A chunk's end indices are contiguous, so they are searched for in place, in
+ * batches (see rt_search_table_find_many()). */
 void *rt_binary_search_thread(void *ptr) {
   search_thread_args *args = (search_thread_args *)ptr;
-  precomputed_and_potential_indices *ppi_cur = args->ppi_head;
+  search_chunk *chunk = NULL;
+
+
+  while ((chunk = get_search_chunk()) != NULL)
+    rt_search_table_find_many(args->table, &(chunk->ppi->precomputed_end_indices[chunk->first]), chunk->last - chunk->first, chunk->hash_number, chunk->first, &add_numbered_search_hit, args->hits);
+
+  return NULL;
+}
+
+
+/* A thread which joins chunks of the sorted precomputed end indices with a table (see
+ * rt_search_table_merge_join()). */
+void *rt_merge_join_thread(void *ptr) {
+  search_thread_args *args = (search_thread_args *)ptr;
+  search_chunk *chunk = NULL;
+
+
+  while ((chunk = get_search_chunk()) != NULL)
+    rt_search_table_merge_join(args->table, sorted_end_indices, chunk->first, chunk->last, cracked_hashes, &add_numbered_search_hit, args->hits);
+
+  return NULL;
+}
+
+
+/* A thread which joins chunks of a table's chains with the end index set (see
+ * rt_search_table_hash_join()). */
+void *rt_hash_join_thread(void *ptr) {
+  search_thread_args *args = (search_thread_args *)ptr;
+  search_chunk *chunk = NULL;
+
+
+  while ((chunk = get_search_chunk()) != NULL)
+    rt_search_table_hash_join(args->table, &end_index_set, chunk->first, chunk->last, cracked_hashes, &add_numbered_search_hit, args->hits);
+
+  return NULL;
+}
+
+
+/* Adds chunks covering positions [first, last) of the current table search's work
+ * (see search_chunk). */
+void add_search_chunks(precomputed_and_potential_indices *ppi, unsigned int hash_number, unsigned int first, unsigned int last) {
+  search_chunk *chunk = NULL;
   unsigned int i = 0;
-  cl_ulong start = 0;
 
 
-  while (ppi_cur != NULL) {
-    if (ppi_cur->plaintext == NULL) { /* If this hash isn't cracked yet... */
-      for (i = 0 + args->thread_number; i < ppi_cur->num_precomputed_end_indices; i += args->total_threads) {
-	if (_rt_binary_search(args->rainbow_table, 0, args->num_chains, ppi_cur->precomputed_end_indices[i], &start)) {
-	  add_potential_start_index_and_position(ppi_cur, start, i);
-	}
+  for (i = first; i < last; i += SEARCH_CHUNK_SIZE) {
+    if (num_search_chunks == search_chunks_size) {
+      search_chunks_size = (search_chunks_size == 0) ? 1024 : search_chunks_size * 2;
+      search_chunks = realloc(search_chunks, search_chunks_size * sizeof(search_chunk));
+      if (search_chunks == NULL) {
+	fprintf(stderr, "Failed to allocate search chunks.\n");
+	exit(-1);
       }
     }
-    ppi_cur = ppi_cur->next;
+
+    chunk = &(search_chunks[num_search_chunks]);
+    chunk->ppi = ppi;
+    chunk->hash_number = hash_number;
+    chunk->first = i;
+    chunk->last = ((last - i) > SEARCH_CHUNK_SIZE) ? (i + SEARCH_CHUNK_SIZE) : last;
+    num_search_chunks++;
   }
+}
 
-  pthread_exit(NULL);
-  return NULL;
+
+/* Splits the search of a table into chunks.  For tree searches, these are taken from
+ * the uncracked hashes only; the joins skip the cracked hashes as they go.  (Both use
+ * cracked_hashes, which must already be filled in; see snapshot_cracked_hashes().) */
+void build_search_chunks(const rt_search_table *table, precomputed_and_potential_indices *ppi_head, unsigned int search_method) {
+  precomputed_and_potential_indices *ppi_cur = NULL;
+  unsigned int hash_number = 0;
+
+
+  num_search_chunks = 0;
+  next_search_chunk = 0;
+  if (search_method == SEARCH_METHOD_MERGE_JOIN)
+    add_search_chunks(NULL, 0, 0, num_sorted_end_indices);
+  else if (search_method == SEARCH_METHOD_HASH_JOIN)
+    add_search_chunks(NULL, 0, 0, table->num_chains);
+  else {
+    for (ppi_cur = ppi_head; ppi_cur != NULL; ppi_cur = ppi_cur->next, hash_number++) {
+      if (!cracked_hashes[hash_number]) /* If this hash isn't cracked yet... */
+	add_search_chunks(ppi_cur, hash_number, 0, ppi_cur->num_precomputed_end_indices);
+    }
+  }
+}
+
+
+/* Numbers the hashes (see numbered_hashes), if that hasn't been done yet. */
+void number_hashes(precomputed_and_potential_indices *ppi_head) {
+  precomputed_and_potential_indices *ppi_cur = NULL;
+  unsigned int num_ppi = 0, hash_number = 0;
+
+
+  if (numbered_hashes != NULL)
+    return;
+
+  for (ppi_cur = ppi_head; ppi_cur != NULL; ppi_cur = ppi_cur->next)
+    num_ppi++;
+
+  numbered_hashes = calloc(num_ppi, sizeof(precomputed_and_potential_indices *));
+  cracked_hashes = calloc(num_ppi, sizeof(unsigned char));
+  if ((numbered_hashes == NULL) || (cracked_hashes == NULL)) {
+    fprintf(stderr, "Failed to allocate hash numbers.\n");
+    exit(-1);
+  }
+
+  for (ppi_cur = ppi_head; ppi_cur != NULL; ppi_cur = ppi_cur->next, hash_number++)
+    numbered_hashes[hash_number] = ppi_cur;
+  num_numbered_hashes = num_ppi;
 }
 
 
-/* Rainbow table binary search.  Searches a table's end indices for any matches with
- * precomputed end indices.  If/when matches are found, the corresponding start indices
- * are added to the precomputed_and_potential_indices's potential_start_indices
- * array. */
-void rt_binary_search(cl_ulong *rainbow_table, unsigned int num_chains, precomputed_and_potential_indices *ppi_head) {
+/* Notes which of the numbered hashes are cracked (see cracked_hashes).  This is done
+ * on the main thread before each table search, since the previous tables' false alarm
+ * checks may crack hashes while it runs (see search_tables()); the search threads and
+ * GPUs use this snapshot instead of reading the hashes' plaintexts. */
+void snapshot_cracked_hashes() {
+  unsigned int hash_number = 0;
+
+
+  pthread_mutex_lock(&cracked_hash_lock);
+  for (hash_number = 0; hash_number < num_numbered_hashes; hash_number++)
+    cracked_hashes[hash_number] = (numbered_hashes[hash_number]->plaintext != NULL);
+  pthread_mutex_unlock(&cracked_hash_lock);
+}
+
+
+/* Returns the total number of precomputed end indices of all hashes.  Returns 0 if
+ * there are none, or if there are too many to tag with an unsigned int position. */
+unsigned int count_end_indices(precomputed_and_potential_indices *ppi_head) {
+  precomputed_and_potential_indices *ppi_cur = NULL;
+  uint64_t total = 0;
+
+
+  for (ppi_cur = ppi_head; ppi_cur != NULL; ppi_cur = ppi_cur->next)
+    total += ppi_cur->num_precomputed_end_indices;
+
+  return (total > UINT_MAX) ? 0 : (unsigned int)total;
+}
+
+
+/* Tags and sorts every hash's precomputed end indices for the sort-merge join.
+ * Cracked hashes are filtered out during the join instead, so this only needs to be
+ * done once.  Returns 1 on success, or 0 if there wasn't enough memory. */
+unsigned int build_sorted_end_indices(precomputed_and_potential_indices *ppi_head) {
+  precomputed_and_potential_indices *ppi_cur = NULL;
+  unsigned int total = count_end_indices(ppi_head), hash_number = 0, i = 0, n = 0;
+
+
+  if (total == 0)
+    return 0;
+
+  sorted_end_indices = calloc(total, sizeof(rt_tagged_end_index));
+  if (sorted_end_indices == NULL)
+    return 0;
+
+  for (ppi_cur = ppi_head; ppi_cur != NULL; ppi_cur = ppi_cur->next, hash_number++) {
+    for (i = 0; i < ppi_cur->num_precomputed_end_indices; i++, n++) {
+      sorted_end_indices[n].end_index = ppi_cur->precomputed_end_indices[i];
+      sorted_end_indices[n].hash_number = hash_number;
+      sorted_end_indices[n].position = i;
+    }
+  }
+
+  qsort(sorted_end_indices, n, sizeof(rt_tagged_end_index), rt_compare_tagged_end_indices);
+  num_sorted_end_indices = n;
+  return 1;
+}
+
+
+/* Inserts every hash's precomputed end indices into the end index set for the hash
+ * join.  Like the sorted end indices, this only needs to be done once.  Returns 1 on
+ * success, or 0 if there wasn't enough memory. */
+unsigned int build_end_index_set(precomputed_and_potential_indices *ppi_head) {
+  precomputed_and_potential_indices *ppi_cur = NULL;
+  unsigned int total = count_end_indices(ppi_head), hash_number = 0, i = 0;
+
+
+  if ((total == 0) || !rt_end_index_set_init(&end_index_set, total))
+    return 0;
+
+  for (ppi_cur = ppi_head; ppi_cur != NULL; ppi_cur = ppi_cur->next, hash_number++) {
+    for (i = 0; i < ppi_cur->num_precomputed_end_indices; i++)
+      rt_end_index_set_add(&end_index_set, ppi_cur->precomputed_end_indices[i], hash_number, i);
+  }
+  return 1;
+}
+
+
+/* Picks the cheapest method to search a table with, given the number of uncracked
+ * precomputed end indices (see snapshot_cracked_hashes()) and the number of chains in
+ * the table.  A tree search costs
+ * a few cache misses per index, a merge join streams through all the sorted indices
+ * and the table once, and a hash join streams through the table once, doing one
+ * random lookup per chain.  If there isn't enough memory to build what a join needs,
+ * the next best method is used instead. */
+unsigned int choose_search_method(const rt_search_table *table, precomputed_and_potential_indices *ppi_head) {
+  static unsigned int sorting_failed = 0, hashing_failed = 0;
+  precomputed_and_potential_indices *ppi_cur = NULL;
+  uint64_t num_queries = 0;
+  unsigned int hash_number = 0;
+
+
+  for (ppi_cur = ppi_head; ppi_cur != NULL; ppi_cur = ppi_cur->next, hash_number++) {
+    if (!cracked_hashes[hash_number])
+      num_queries += ppi_cur->num_precomputed_end_indices;
+  }
+
+  if (num_queries >= ((uint64_t)table->num_chains * HASH_JOIN_QUERIES_PER_CHAIN)) {
+    if ((end_index_set.slots == NULL) && !hashing_failed) {
+      if (!build_end_index_set(ppi_head)) {
+	printf("  Not enough memory to hash precomputed end indices; using merge joins.\n");
+	hashing_failed = 1;
+      }
+    }
+
+    if (end_index_set.slots != NULL)
+      return SEARCH_METHOD_HASH_JOIN;
+  }
+
+  if ((num_queries * MERGE_JOIN_CHAINS_PER_QUERY) < table->num_chains)
+    return SEARCH_METHOD_TREE;
+
+  if ((sorted_end_indices == NULL) && !sorting_failed) {
+    if (!build_sorted_end_indices(ppi_head)) {
+      printf("  Not enough memory to sort precomputed end indices; using tree searches.\n");
+      sorting_failed = 1;
+    }
+  }
+  return (sorted_end_indices != NULL) ? SEARCH_METHOD_MERGE_JOIN : SEARCH_METHOD_TREE;
+}
+
+
+/* Rainbow table search.  Searches a table's end indices for any matches with
+ * precomputed end indices, with its search tree (see rt_search.c), a sort-merge join,
+ * or a hash join, depending on how many indices there are to look up.  If/when
+ * matches are found, each search thread adds the corresponding start indices to its
+ * own hit buffer; these are then merged into the false alarm candidates. */
+void rt_binary_search(const rt_search_table *table, precomputed_and_potential_indices *ppi_head, false_alarm_candidates *candidates) {
   struct timespec start_time_searching = {0};
   char time_searching_str[64] = {0};
   unsigned int num_threads = get_num_cpu_cores();
-  pthread_t *threads = NULL;
   search_thread_args *args = NULL;
-  unsigned int i = 0;
+  thread_pool_func search_thread = NULL;
+  unsigned int i = 0, search_method = 0;
   double s_time = 0;
+  thread_pool_group group = {0};
 
 
   start_timer(&start_time_searching);
+  number_hashes(ppi_head);
+  snapshot_cracked_hashes();
+  search_method = choose_search_method(table, ppi_head);
   args = calloc(num_threads, sizeof(search_thread_args));
-  threads = calloc(num_threads, sizeof(pthread_t));
-  if ((args == NULL) || (threads == NULL)) {
+  if (args == NULL) {
     fprintf(stderr, "Failed to create thread/args for searching.\n");
     exit(-1);
   }
 
-  printf("  Searching table for matching endpoints...\n");  fflush(stdout);
+  /* The hit buffers are created once, and kept for all tables. */
+  if (hit_buffers == NULL) {
+    hit_buffers = calloc(num_threads, sizeof(hit_buffer));
+    if (hit_buffers == NULL) {
+      fprintf(stderr, "Failed to create hit buffers for searching.\n");
+      exit(-1);
+    }
+    num_hit_buffers = num_threads;
+  }
+
+  if (search_method == SEARCH_METHOD_MERGE_JOIN) {
+    printf("  Searching table for matching endpoints (merge join)...\n");
+    search_thread = &rt_merge_join_thread;
+  } else if (search_method == SEARCH_METHOD_HASH_JOIN) {
+    printf("  Searching table for matching endpoints (hash join)...\n");
+    search_thread = &rt_hash_join_thread;
+  } else {
+    printf("  Searching table for matching endpoints...\n");
+    search_thread = &rt_binary_search_thread;
+  }
+  fflush(stdout);
 
+  build_search_chunks(table, ppi_head, search_method);
   for (i = 0; i < num_threads; i++) {
-    args[i].thread_number = i;
-    args[i].total_threads = num_threads;
-    args[i].rainbow_table = rainbow_table;
-    args[i].num_chains = num_chains;
-    args[i].ppi_head = ppi_head;
+    args[i].table = table;
+    args[i].hits = &(hit_buffers[i]);
+    thread_pool_submit(worker_pool, &group, search_thread, &(args[i]));
+  }
 
-    if (pthread_create(&(threads[i]), NULL, &rt_binary_search_thread, &(args[i]))) {
-      perror("Failed to create thread");
+  /* Wait for all tasks to finish. */
+  thread_pool_wait(worker_pool, &group);
+
+  merge_hit_buffers(candidates);
+
+  s_time = get_elapsed(&start_time_searching);
+  seconds_to_human_time(time_searching_str, sizeof(time_searching_str), s_time);
+  printf("  Table searched in %s.\n", time_searching_str);  fflush(stdout);
+
+  time_searching += s_time;
+  FREE(args);
+}
+
+
+/* Loads the search kernel on a GPU, copies the sorted precomputed end indices to it,
+ * and creates the buffers for searching tables.  These stay on the GPU for all
+ * tables. */
+void gpu_search_init(gpu_searcher *gs) {
+  cl_context context = NULL;
+  cl_command_queue queue = NULL;
+  cl_kernel kernel = NULL;
+  int err = 0;
+  unsigned int slot = 0;
+
+
+  gpu_session_get_kernel(&(gpu_sessions[gs->args->gpu.device_number]), SEARCH_TABLE_KERNEL_PATH, "search_table", gs->args->hash_type, NULL, &(gs->context), &(gs->program), &(gs->kernel), &(gs->queue));
+
+  /* These variables are set so the CLCREATEARG* macros work correctly. */
+  context = gs->context;
+  queue = gs->queue;
+  kernel = gs->kernel;
+
+  CLCREATEARG_ARRAY(0, gs->sorted_end_indices_buffer, CL_RO, sorted_end_indices, num_sorted_end_indices * sizeof(rt_tagged_end_index));
+  CLCREATEARG(1, gs->num_sorted_end_indices_buffer, CL_RO, num_sorted_end_indices, sizeof(cl_uint));
+
+  CLCREATEBUFFER(gs->cracked_buffer, CL_RO, num_numbered_hashes * sizeof(unsigned char));
+
+  /* Each chunk also holds the end index of the chain before it (see
+   * host_thread_search()). */
+  for (slot = 0; slot < 2; slot++) {
+    gs->max_hits[slot] = GPU_SEARCH_INITIAL_HITS;
+    gs->hits_block[slot] = calloc(gs->max_hits[slot], sizeof(gpu_search_hit));
+    if (gs->hits_block[slot] == NULL) {
+      fprintf(stderr, "Error while allocating GPU search buffers.\n");
       exit(-1);
     }
+
+    CLCREATEBUFFER(gs->table_end_indices_buffer[slot], CL_RO, (GPU_SEARCH_CHUNK_CHAINS + 1) * sizeof(cl_ulong));
+    CLCREATEBUFFER(gs->num_table_end_indices_buffer[slot], CL_RO, sizeof(cl_uint));
+    CLCREATEBUFFER(gs->first_buffer[slot], CL_RO, sizeof(cl_uint));
+    CLCREATEBUFFER(gs->chain_offset_buffer[slot], CL_RO, sizeof(cl_uint));
+    CLCREATEBUFFER(gs->max_hits_buffer[slot], CL_RO, sizeof(cl_uint));
+    CLCREATEBUFFER(gs->num_hits_buffer[slot], CL_RW, sizeof(cl_uint));
+    CLCREATEBUFFER(gs->hits_buffer[slot], CL_WO, gs->max_hits[slot] * sizeof(gpu_search_hit));
   }
+}
 
-  /* Wait for all threads to finish. */
-  for (i = 0; i < num_threads; i++) {
-    if (pthread_join(threads[i], NULL) != 0) {
-      perror("Failed to join with thread");
+
+/* Queues up a search of the chunk in one of a GPU's sets of buffers, followed by
+ * reads of its hit count and its hits, without waiting on any of them.  The event of
+ * the last read is stored in hits_read.  num_hits must stay untouched until then, since
+ * it is also where the hit count is reset from. */
+void gpu_search_queue_chunk(gpu_searcher *gs, unsigned int slot, size_t *gws, cl_uint *num_hits, cl_event *hits_read) {
+  cl_command_queue queue = gs->queue;
+  cl_kernel kernel = gs->kernel;
+  int err = 0;
+
+
+  *num_hits = 0;
+  CLWRITEBUFFERASYNC(gs->max_hits_buffer[slot], sizeof(cl_uint), &(gs->max_hits[slot]));
+  CLWRITEBUFFERASYNC(gs->num_hits_buffer[slot], sizeof(cl_uint), num_hits);
+  CLSETARG(3, gs->table_end_indices_buffer[slot]);
+  CLSETARG(4, gs->num_table_end_indices_buffer[slot]);
+  CLSETARG(5, gs->first_buffer[slot]);
+  CLSETARG(6, gs->chain_offset_buffer[slot]);
+  CLSETARG(7, gs->max_hits_buffer[slot]);
+  CLSETARG(8, gs->num_hits_buffer[slot]);
+  CLSETARG(9, gs->hits_buffer[slot]);
+
+  CLRUNKERNEL(gs->queue, gs->kernel, gws);
+
+  /* The whole hits buffer is read, so that the read doesn't have to wait for the hit
+   * count.  (It is small compared to the chunk's end indices.) */
+  CLREADBUFFERASYNC(gs->num_hits_buffer[slot], sizeof(cl_uint), num_hits, NULL);
+  CLREADBUFFERASYNC(gs->hits_buffer[slot], gs->max_hits[slot] * sizeof(gpu_search_hit), gs->hits_block[slot], hits_read);
+  CLFLUSH(gs->queue);
+}
+
+
+/* Grows one of a GPU's hits buffers to hold the specified number of hits. */
+void gpu_search_grow_hits(gpu_searcher *gs, unsigned int slot, unsigned int max_hits) {
+  cl_context context = gs->context;
+  int err = 0;
+
+
+  CLFREEBUFFER(gs->hits_buffer[slot]);
+  FREE(gs->hits_block[slot]);
+  gs->max_hits[slot] = max_hits;
+  gs->hits_block[slot] = calloc(gs->max_hits[slot], sizeof(gpu_search_hit));
+  if (gs->hits_block[slot] == NULL) {
+    fprintf(stderr, "Error while allocating GPU search buffers.\n");
+    exit(-1);
+  }
+  CLCREATEBUFFER(gs->hits_buffer[slot], CL_WO, gs->max_hits[slot] * sizeof(gpu_search_hit));
+}
+
+
+/* Adds the hits that the search kernel found in one of a GPU's sets of buffers to its
+ * hits for the current table. */
+void gpu_search_add_hits(gpu_searcher *gs, unsigned int slot, unsigned int num_hits) {
+  if ((gs->num_hits + num_hits) > gs->hits_size) {
+    gs->hits_size = gs->num_hits + num_hits;
+    gs->hits = realloc(gs->hits, gs->hits_size * sizeof(gpu_search_hit));
+    if (gs->hits == NULL) {
+      fprintf(stderr, "Error while allocating GPU search hits.\n");
+      exit(-1);
+    }
+  }
+
+  memcpy(&(gs->hits[gs->num_hits]), gs->hits_block[slot], num_hits * sizeof(gpu_search_hit));
+  gs->num_hits += num_hits;
+}
+
+
+/* A thread which searches a range of a table's chains on one GPU.  The table's end
+ * indices are streamed to the GPU in chunks of GPU_SEARCH_CHUNK_CHAINS.  Two sets of
+ * buffers are used: the next chunk is queued up while the hits of the previous one are
+ * collected, so the GPU doesn't sit idle between chunks. */
+void *host_thread_search(void *ptr) {
+  gpu_searcher *gs = (gpu_searcher *)ptr;
+  const rt_search_table *table = gs->table;
+  cl_command_queue queue = NULL;
+  cl_kernel kernel = NULL;
+  int err = 0;
+
+  cl_event hits_read[2] = {NULL};
+  cl_uint num_table_end_indices[2] = {0}, first[2] = {0}, base[2] = {0}, num_hits[2] = {0};
+  unsigned int num_chunks = 0, chunk = 0, slot = 0, chain = 0, chunk_end = 0;
+  size_t gws[2] = {0};
+
+
+  gs->num_hits = 0;
+  if (gs->first_chain == gs->last_chain)
+    return NULL;
+
+  if (gs->context == NULL)
+    gpu_search_init(gs);
+
+  /* These variables are set so the CL* macros work correctly. */
+  queue = gs->queue;
+  kernel = gs->kernel;
+
+  /* Hashes that were cracked before this table's search started are skipped by the
+   * kernel.  The snapshot isn't changed until all GPUs are done with this table. */
+  CLWRITEBUFFERASYNC(gs->cracked_buffer, num_numbered_hashes * sizeof(unsigned char), cracked_hashes);
+  CLSETARG(2, gs->cracked_buffer);
+
+  /* One extra pass is made to collect the hits of the last chunk. */
+  num_chunks = ((gs->last_chain - gs->first_chain) + GPU_SEARCH_CHUNK_CHAINS - 1) / GPU_SEARCH_CHUNK_CHAINS;
+  for (chunk = 0; chunk <= num_chunks; chunk++) {
+    slot = chunk % 2;
+
+    if (chunk < num_chunks) {
+      chain = gs->first_chain + (chunk * GPU_SEARCH_CHUNK_CHAINS);
+      chunk_end = ((gs->last_chain - chain) > GPU_SEARCH_CHUNK_CHAINS) ? (chain + GPU_SEARCH_CHUNK_CHAINS) : gs->last_chain;
+
+      /* The chain before the chunk is sent too, so the kernel can tell whether the
+       * chunk's first chain is a duplicate. */
+      base[slot] = (chain > 0) ? (chain - 1) : 0;
+      first[slot] = chain - base[slot];
+      num_table_end_indices[slot] = chunk_end - base[slot];
+      gws[slot] = chunk_end - chain;
+
+      CLWRITEBUFFERASYNC(gs->table_end_indices_buffer[slot], num_table_end_indices[slot] * sizeof(cl_ulong), &(table->end_indices[base[slot]]));
+      CLWRITEBUFFERASYNC(gs->num_table_end_indices_buffer[slot], sizeof(cl_uint), &(num_table_end_indices[slot]));
+      CLWRITEBUFFERASYNC(gs->first_buffer[slot], sizeof(cl_uint), &(first[slot]));
+      CLWRITEBUFFERASYNC(gs->chain_offset_buffer[slot], sizeof(cl_uint), &(base[slot]));
+      gpu_search_queue_chunk(gs, slot, &(gws[slot]), &(num_hits[slot]), &(hits_read[slot]));
+    }
+
+    /* While that chunk runs, collect the hits of the one before it. */
+    if (chunk > 0) {
+      slot = (chunk - 1) % 2;
+      CLWAITEVENT(hits_read[slot]);
+
+      /* If the hits buffer was too small, grow it and search the chunk again.  Its end
+       * indices are still in its buffers, since the next chunk uses the other set. */
+      if (num_hits[slot] > gs->max_hits[slot]) {
+	gpu_search_grow_hits(gs, slot, num_hits[slot]);
+	gpu_search_queue_chunk(gs, slot, &(gws[slot]), &(num_hits[slot]), &(hits_read[slot]));
+	CLWAITEVENT(hits_read[slot]);
+      }
+
+      gpu_search_add_hits(gs, slot, num_hits[slot]);
+    }
+  }
+
+  return NULL;
+}
+
+
+/* Searches a table on the GPUs, with the sorted precomputed end indices kept on each
+ * device.  Each GPU searches its own range of the table's chains.  The hits that the
+ * GPUs return are turned directly into the false alarm candidates.  Returns 1 on
+ * success, or 0 if the precomputed end indices couldn't be sorted (in which case the
+ * table must be searched on the CPU). */
+unsigned int gpu_search_table(const rt_search_table *table, precomputed_and_potential_indices *ppi_head, false_alarm_candidates *candidates, thread_args *args) {
+  static unsigned int sorting_failed = 0;
+  struct timespec start_time_searching = {0};
+  char time_searching_str[64] = {0};
+  unsigned int total_devices = args[0].total_devices, num_candidates = 0, i = 0, j = 0, n = 0;
+  gpu_search_hit *hit = NULL;
+  double s_time = 0;
+  thread_pool_group group = {0};
+
+
+  if (sorting_failed)
+    return 0;
+
+  start_timer(&start_time_searching);
+  number_hashes(ppi_head);
+  snapshot_cracked_hashes();
+  if ((sorted_end_indices == NULL) && !build_sorted_end_indices(ppi_head)) {
+    printf("  Not enough memory to sort precomputed end indices; searching tables on the CPU.\n");
+    sorting_failed = 1;
+    return 0;
+  }
+
+  printf("  Searching table for matching endpoints (GPU)...\n");  fflush(stdout);
+
+  /* Run one task to control each GPU. */
+  for (i = 0; i < total_devices; i++) {
+    gpu_searchers[i].args = &(args[i]);
+    gpu_searchers[i].table = table;
+    gpu_searchers[i].first_chain = (unsigned int)(((uint64_t)table->num_chains * i) / total_devices);
+    gpu_searchers[i].last_chain = (unsigned int)(((uint64_t)table->num_chains * (i + 1)) / total_devices);
+    thread_pool_submit(worker_pool, &group, &host_thread_search, &(gpu_searchers[i]));
+  }
+
+  /* Wait for all tasks to finish. */
+  thread_pool_wait(worker_pool, &group);
+
+  memset(candidates, 0, sizeof(false_alarm_candidates));
+  for (i = 0; i < total_devices; i++)
+    num_candidates += gpu_searchers[i].num_hits;
+
+  if (num_candidates > 0) {
+    candidates->start_indices = calloc(num_candidates, sizeof(cl_ulong));
+    candidates->positions = calloc(num_candidates, sizeof(unsigned int));
+    candidates->ppi_refs = calloc(num_candidates, sizeof(precomputed_and_potential_indices *));
+    if ((candidates->start_indices == NULL) || (candidates->positions == NULL) || (candidates->ppi_refs == NULL)) {
+      fprintf(stderr, "Error while creating buffer for potential start indices/positions/ppi refs.\n");
       exit(-1);
     }
+
+    for (i = 0; i < total_devices; i++) {
+      for (j = 0; j < gpu_searchers[i].num_hits; j++, n++) {
+	hit = &(gpu_searchers[i].hits[j]);
+	candidates->start_indices[n] = table->start_indices[hit->chain];
+	candidates->positions[n] = hit->position;
+	candidates->ppi_refs[n] = numbered_hashes[hit->hash_number];
+      }
+    }
+    candidates->num_candidates = n;
   }
 
   s_time = get_elapsed(&start_time_searching);
@@ -1534,8 +2652,43 @@ void rt_binary_search(cl_ulong *rainbow_table, unsigned int num_chains, precompu
   printf("  Table searched in %s.\n", time_searching_str);  fflush(stdout);
 
   time_searching += s_time;
-  FREE(args);
-  FREE(threads);
+  return 1;
+}
+
+
+/* Releases the GPUs' search kernels and buffers. */
+void free_gpu_searchers() {
+  gpu_searcher *gs = NULL;
+  unsigned int i = 0, slot = 0;
+
+
+  for (i = 0; i < MAX_NUM_DEVICES; i++) {
+    gs = &(gpu_searchers[i]);
+
+    CLFREEBUFFER(gs->sorted_end_indices_buffer);
+    CLFREEBUFFER(gs->num_sorted_end_indices_buffer);
+    CLFREEBUFFER(gs->cracked_buffer);
+
+    for (slot = 0; slot < 2; slot++) {
+      CLFREEBUFFER(gs->table_end_indices_buffer[slot]);
+      CLFREEBUFFER(gs->num_table_end_indices_buffer[slot]);
+      CLFREEBUFFER(gs->first_buffer[slot]);
+      CLFREEBUFFER(gs->chain_offset_buffer[slot]);
+      CLFREEBUFFER(gs->max_hits_buffer[slot]);
+      CLFREEBUFFER(gs->num_hits_buffer[slot]);
+      CLFREEBUFFER(gs->hits_buffer[slot]);
+      FREE(gs->hits_block[slot]);
+      gs->max_hits[slot] = 0;
+    }
+
+    /* The context and kernel belong to the device's session. */
+    gs->kernel = NULL;
+    gs->program = NULL;
+    gs->queue = NULL;
+    gs->context = NULL;
+    FREE(gs->hits);
+    gs->num_hits = gs->hits_size = 0;
+  }
 }
 
 
@@ -1733,11 +2886,65 @@ preloaded_table *get_preloaded_table() {
 }
 
 
+/* Checks a batch of tables' false alarm candidates, then reports on their progress.
+ * This runs in the worker pool while the next tables are searched. */
+void *false_alarm_stage_thread(void *ptr) {
+  false_alarm_stage *stage = (false_alarm_stage *)ptr;
+
+
+  check_false_alarms(stage->ppi_head, &(stage->candidates), stage->args);
+
+  /* The next tables are being searched meanwhile, so don't interleave with any other
+   * output. */
+  pthread_mutex_lock(&cracked_hash_lock);
+  if (stage->first_table == stage->last_table)
+    printf("  Table %u fully processed in %.1f seconds.\n", stage->first_table, get_elapsed(&(stage->start_time)));
+  else
+    printf("  Tables %u to %u fully processed in %.1f seconds.\n", stage->first_table, stage->last_table, get_elapsed(&(stage->start_time)));
+  fflush(stdout);
+  print_eta_search(num_tables_processed, total_tables);
+  printf("  Cracked %u of %u hashes.\n\n", num_cracked, num_hashes);  fflush(stdout);
+  pthread_mutex_unlock(&cracked_hash_lock);
+  return NULL;
+}
+
+
+/* Returns 1 if the false alarm checks of one batch of tables should run alongside the
+ * next tables' searches.  This is only worth it when the GPUs check them; otherwise,
+ * the checks and the searches would both be competing for the same CPU cores. */
+unsigned int use_false_alarm_pipeline(unsigned int total_devices) {
+  return (!use_cpu && (total_devices > 0)) ? 1 : 0;
+}
+
+
+/* Starts checking a batch of tables' false alarms, once the previous batch's checks
+ * are done.  Nothing is searching then, so the end indices of any hashes that the
+ * previous checks cracked are freed. */
+void start_false_alarm_stage(false_alarm_stage *stage, thread_pool_group *stage_group, precomputed_and_potential_indices *ppi_head) {
+  thread_pool_wait(worker_pool, stage_group);
+  free_cracked_end_indices(ppi_head);
+
+  thread_pool_submit(worker_pool, stage_group, &false_alarm_stage_thread, stage);
+}
+
+
+/* Searches all the tables, and checks their false alarms.  When the GPUs check false
+ * alarms, these are done in a two-stage pipeline: while one batch of tables' false
+ * alarms are checked, the next tables are searched.  Hashes cracked by one batch's
+ * checks are skipped by the next tables' searches wherever they haven't gotten to
+ * them yet, and are dropped from the next batch's candidates before they are checked.
+ * A batch holds as many tables as it takes to collect FALSE_ALARM_BATCH_SIZE
+ * candidates, or FALSE_ALARM_BATCH_SECONDS worth of tables.
+ *
+ * When the CPU checks false alarms, both stages would need all of its cores, so each
+ * table's false alarms are checked right after it is searched instead. */
 void search_tables(unsigned int total_tables, precomputed_and_potential_indices *ppi, thread_args *args) {
-  unsigned int num_uncracked = 0, current_table = 0;
-  struct timespec start_time_table = {0};
+  unsigned int num_uncracked = 0, current_table = 0, cur = 0, pipeline = use_false_alarm_pipeline(args[0].total_devices);
   precomputed_and_potential_indices *ppi_cur = NULL;
   preloaded_table *pt = NULL;
+  false_alarm_stage stages[2] = {0};
+  false_alarm_candidates table_candidates = {0};
+  thread_pool_group stage_group = {0};
 
 
   while (1) {
@@ -1767,31 +2974,51 @@ void search_tables(unsigned int total_tables, precomputed_and_potential_indices
     current_table++;
     printf("[%u of %u] Processing table: %s...\n", current_table, total_tables, pt->filepath);  fflush(stdout);
 
-    start_timer(&start_time_table);
-    rt_binary_search(pt->rainbow_table, pt->num_chains, ppi);
+    /* Start a new batch, if the last one was sent off to be checked. */
+    if (stages[cur].first_table == 0) {
+      stages[cur].ppi_head = ppi;
+      stages[cur].args = args;
+      stages[cur].first_table = current_table;
+      start_timer(&(stages[cur].start_time));
+    }
+    stages[cur].last_table = current_table;
+
+    if (!use_gpu_search || use_cpu || (args[0].total_devices == 0) || !gpu_search_table(&(pt->table), ppi, &table_candidates, args))
+      rt_binary_search(&(pt->table), ppi, &table_candidates);
+    append_false_alarm_candidates(&(stages[cur].candidates), &table_candidates);
 
-    num_chains_processed += pt->num_chains;
+    num_chains_processed += pt->table.num_chains;
     num_tables_processed++;
 
     /* Free the preloaded table. */
     FREE(pt->filepath);
-    FREE(pt->rainbow_table);
-    pt->num_chains = 0;
+    rt_search_table_free(&(pt->table));
     FREE(pt);
 
-    /* Check endpoint matches. */
-    check_false_alarms(ppi, args);
-
-    printf("  Table fully processed in %.1f seconds.\n", get_elapsed(&start_time_table)); fflush(stdout);
-    print_eta_search(num_tables_processed, total_tables);
-    printf("  Cracked %u of %u hashes.\n\n", num_cracked, num_hashes);
+    /* Without the pipeline, check this table's endpoint matches now. */
+    if (!pipeline) {
+      false_alarm_stage_thread(&(stages[cur]));
+      free_cracked_end_indices(ppi);
+      stages[cur].first_table = 0;
+      continue;
+    }
 
-    /* We checked the potential matches above, so there's nothing else to do with
-     * them. */
-    clear_potential_start_indices(ppi);
+    /* Keep adding tables to the batch until it is big (or old) enough. */
+    if ((stages[cur].candidates.num_candidates < FALSE_ALARM_BATCH_SIZE) && (get_elapsed(&(stages[cur].start_time)) < FALSE_ALARM_BATCH_SECONDS))
+      continue;
 
+    /* Check this batch's endpoint matches while the next tables are searched. */
+    start_false_alarm_stage(&(stages[cur]), &stage_group, ppi);
+    cur = !cur;
+    stages[cur].first_table = 0;
   }
 
+  /* Check the last batch, if it wasn't full, then wait for all checks to finish. */
+  if (stages[cur].first_table != 0)
+    start_false_alarm_stage(&(stages[cur]), &stage_group, ppi);
+  thread_pool_wait(worker_pool, &stage_group);
+  free_cracked_end_indices(ppi);
+
   /* Free any remaining preloaded tables (i.e.: if we cracked all the hashes and quit early). */
   /* Note: technically, this may not be a complete solution, if this is reached while the preloading
    * thread is still performing work... */
@@ -1800,19 +3027,29 @@ void search_tables(unsigned int total_tables, precomputed_and_potential_indices
     preloaded_table *pt_next = preloaded_table_list->next;
 
     FREE(preloaded_table_list->filepath);
-    FREE(preloaded_table_list->rainbow_table);
-    preloaded_table_list->num_chains = 0;
+    rt_search_table_free(&(preloaded_table_list->table));
     FREE(preloaded_table_list);
 
     preloaded_table_list = pt_next;
   }
   pthread_mutex_unlock(&preloaded_tables_lock);
+
+  FREE(sorted_end_indices);
+  num_sorted_end_indices = 0;
+  rt_end_index_set_free(&end_index_set);
+  FREE(numbered_hashes);
+  FREE(cracked_hashes);
+  num_numbered_hashes = 0;
+  free_gpu_searchers();
+  FREE(search_chunks);
+  num_search_chunks = search_chunks_size = 0;
+  free_hit_buffers();
 }
 
 
 int main(int ac, char **av) {
-  char *rt_dir = NULL, *single_hash = NULL, *filename = NULL, *file_data = NULL, **usernames = NULL, **hashes = NULL, *line = NULL, *pot_file_data = NULL;
-  unsigned int i = 0, j = 0, max_num_hashes = 0, num_colons = 0, file_format = 0, err = 0;
+  char *rt_dir = NULL, *pot_filename = NULL, *single_hash = NULL, *filename = NULL, *file_data = NULL, **usernames = NULL, **hashes = NULL, *line = NULL, *pot_file_data = NULL;
+  unsigned int i = 0, j = 0, max_num_hashes = 0, num_colons = 0, file_format = 0, err = 0, num_args = 0;
   FILE *f = NULL;
   struct stat st = {0};
   thread_args *args = NULL;
@@ -1826,6 +3063,7 @@ int main(int ac, char **av) {
   cl_uint num_platforms = 0, num_devices = 0;
 
   precomputed_and_potential_indices *ppi_head = NULL, *ppi_cur = NULL;
+  const hash_provider *hp = NULL;
 
   pthread_t preload_thread_id = {0};
   preloading_thread_args preload_thread_args = {0};
@@ -1834,20 +3072,31 @@ int main(int ac, char **av) {
   ENABLE_CONSOLE_COLOR();
   PRINT_PROJECT_HEADER();
   setlocale(LC_NUMERIC, "");
-  if ((ac < 3) || (ac > 5))
-    print_usage_and_exit(av[0], -1);
-  else if ((ac == 5) && (strcmp(av[3], "-gws") != 0) && (strcmp(av[3], "-disable-platform") != 0))
+  if (ac < 3)
     print_usage_and_exit(av[0], -1);
 
-  if (ac == 5) {
-    if (strcmp(av[3], "-gws") == 0)
-      user_provided_gws = (unsigned int)atoi(av[4]);
-    else if (strcmp(av[3], "-disable-platform") == 0)
-      disable_platform = (unsigned int)atoi(av[4]);
+  for (i = 3; i < ac; i++) {
+    if ((strcmp(av[i], "-gws") == 0) && (i + 1 < ac)) {
+      user_provided_gws = (unsigned int)atoi(av[i + 1]);
+      i++;
+    } else if ((strcmp(av[i], "-disable-platform") == 0) && (i + 1 < ac)) {
+      disable_platform = (unsigned int)atoi(av[i + 1]);
+      i++;
+    } else if (strcmp(av[i], "-cpu") == 0)
+      use_cpu = 1;
+    else if (strcmp(av[i], "-gpu-search") == 0)
+      use_gpu_search = 1;
+    else if ((av[i][0] != '-') && (pot_filename == NULL))
+      pot_filename = av[i];
+    else
+      print_usage_and_exit(av[0], -1);
   }
 
-  /* Initialize the devices. */
-  get_platforms_and_devices(disable_platform, MAX_NUM_PLATFORMS, platforms, &num_platforms, MAX_NUM_DEVICES, devices, &num_devices, VERBOSE);
+  /* Initialize the devices, unless everything is to be done on the CPU. */
+  if (use_cpu)
+    printf("Pre-computation will be done with %u CPU threads.\n", get_num_cpu_cores());
+  else
+    get_platforms_and_devices(disable_platform, MAX_NUM_PLATFORMS, platforms, &num_platforms, MAX_NUM_DEVICES, devices, &num_devices, VERBOSE);
 
   /* Check the device type and set flags.*/
   if (num_devices > 0) {
@@ -1867,7 +3116,7 @@ int main(int ac, char **av) {
 
   /* Initialize the barrier.  This is used in some cases to ensure kernels across
    * multiple devices run concurrently. */
-  if (pthread_barrier_init(&barrier, NULL, num_devices) != 0) {
+  if (pthread_barrier_init(&barrier, NULL, (num_devices > 0) ? num_devices : 1) != 0) {
     fprintf(stderr, "pthread_barrier_init() failed.\n");
     exit(-1);
   }
@@ -1879,10 +3128,10 @@ int main(int ac, char **av) {
 
   /* The default rainbowcrackalack.pot file can be overridden with a third argument.
    * This is undocumented since its probably only useful for automated testing. */
-  if (ac == 4) {
-    strncpy(jtr_pot_filename, av[3], sizeof(jtr_pot_filename) - 1);
+  if (pot_filename != NULL) {
+    strncpy(jtr_pot_filename, pot_filename, sizeof(jtr_pot_filename) - 1);
     jtr_pot_filename[sizeof(jtr_pot_filename) - 1] = '\0';
-    strncpy(hashcat_pot_filename, av[3], sizeof(hashcat_pot_filename) - 1);
+    strncpy(hashcat_pot_filename, pot_filename, sizeof(hashcat_pot_filename) - 1);
     hashcat_pot_filename[sizeof(hashcat_pot_filename) - 1] = '\0';
     strncat(hashcat_pot_filename, ".hashcat", sizeof(hashcat_pot_filename) - 1);
   }
@@ -2117,19 +3366,19 @@ int main(int ac, char **av) {
     exit(-1);
   }
 
-  /* At this time, only NTLM hashes are supported. */
-  if (rt_params.hash_type != HASH_NTLM) {
-    fprintf(stderr, "Unfortunately, only NTLM hashes are supported at this time.  Terminating.\n");
+  /* At this time, only hashes with a CPU implementation (NTLM, MD5, and SHA-1) are
+   * supported, since results are double-checked on the CPU. */
+  hp = get_hash_provider(rt_params.hash_type);
+  if (hp == NULL) {
+    fprintf(stderr, "Unfortunately, only NTLM, MD5, and SHA-1 hashes are supported at this time.  Terminating.\n");
     exit(-1);
   }
 
   /* Ensure that valid hashes were provided. */
-  if (rt_params.hash_type == HASH_NTLM) {
-    for (i = 0; i < num_hashes; i++) {
-      if (strlen(hashes[i]) != 32) {
-	fprintf(stderr, "Error: invalid NTLM hash (length is not 32!): %s\n", hashes[i]);
-	exit(-1);
-      }
+  for (i = 0; i < num_hashes; i++) {
+    if (strlen(hashes[i]) != (hp->hash_len * 2)) {
+      fprintf(stderr, "Error: invalid %s hash (length is not %u!): %s\n", hp->name, hp->hash_len * 2, hashes[i]);
+      exit(-1);
     }
   }
 
@@ -2139,7 +3388,10 @@ int main(int ac, char **av) {
     printf("\n\n\n\t!! WARNING !!\n\nA large group of hashes was provided (%u).  In general, rainbow tables are only effective to use for small numbers of hashes because there is a pre-computation step that must be done on *each hash*; eventually this pre-computation cost becomes high enough that brute-force would be a better strategy.  The point at which this happens depends on your specific GPU hardware.\n\nFor example, suppose the pre-computation step takes 2.8 seconds per hash, and brute-forcing takes 16 hours (57,600 seconds).  Not counting search time nor false alarm checking, the point at which brute-forcing becomes more efficient than rainbow tables is: 57,600 / 2.8 = ~20,571 hashes.  Trying to crack more than this number of hashes is clearly less effective than brute-force.\n\nPay attention to the pre-computation times below, and compare with the reported estimate that hashcat gives after a few minutes for brute-forcing 8-character NTLM (hint: ./hashcat -m 1000 -a 3 -w 3 -O ffffffffffffffffffffffffffffffff ?a?a?a?a?a?a?a?a).\n\n\n\n", num_hashes);  fflush(stdout);
   }
 
-  args = calloc(num_devices, sizeof(thread_args));
+  /* When running on the CPU only, there are no devices, but the first set of args
+   * still holds the table parameters. */
+  num_args = (num_devices > 0) ? num_devices : 1;
+  args = calloc(num_args, sizeof(thread_args));
   if (args == NULL) {
     fprintf(stderr, "Error while creating thread arg array.\n");
     goto err;
@@ -2147,7 +3399,7 @@ int main(int ac, char **av) {
 
   /* We set most of the args once, since all GPUs & hashes need all the same
    * parameters. */
-  for (i = 0; i < num_devices; i++) {
+  for (i = 0; i < num_args; i++) {
     args[i].hash_type = rt_params.hash_type;
     args[i].hash_name = rt_params.hash_name;
     args[i].username = NULL;  /* Filled in below. */
@@ -2161,8 +3413,11 @@ int main(int ac, char **av) {
     args[i].chain_len = rt_params.chain_len;
     args[i].total_devices = num_devices;
     args[i].gpu.device_number = i;
-    args[i].gpu.device = devices[i];
-    get_device_uint(args[i].gpu.device, CL_DEVICE_MAX_COMPUTE_UNITS, &(args[i].gpu.num_work_units));
+    if (i < num_devices) {
+      args[i].gpu.device = devices[i];
+      get_device_uint(args[i].gpu.device, CL_DEVICE_MAX_COMPUTE_UNITS, &(args[i].gpu.num_work_units));
+      gpu_session_init(&(gpu_sessions[i]), devices[i]);
+    }
   }
 
   num_hashes_precomputed_total = num_hashes;
@@ -2170,7 +3425,7 @@ int main(int ac, char **av) {
   for (i = 0; i < num_hashes; i++) {
     printf("Pre-computing hash #%u: %s...\n", i + 1, hashes[i]);  fflush(stdout);
 
-    for (j = 0; j < num_devices; j++) {
+    for (j = 0; j < num_args; j++) {
       args[j].username = usernames[i];
       args[j].hash = hashes[i];
     }
@@ -2197,8 +3452,19 @@ int main(int ac, char **av) {
   /* Using the pre-computed end indices, perform a binary search on all rainbow tables
    * in the target directory.  Any matching indices will trigger false alarm checks. */
   total_tables = count_tables(rt_dir);
+
+  /* The pool has a worker for each CPU core to search tables with, plus one per device
+   * for the GPU tasks (which wait on each other at a barrier).  When the previous
+   * tables' false alarms are checked while the next are searched, that needs one more
+   * worker. */
+  worker_pool = thread_pool_create(get_num_cpu_cores() + num_devices + use_false_alarm_pipeline(num_devices));
+
   start_timer(&search_start_time);
   search_tables(total_tables, ppi_head, args);
+  thread_pool_destroy(worker_pool);  worker_pool = NULL;
+
+  for (i = 0; i < num_devices; i++)
+    gpu_session_free(&(gpu_sessions[i]));
 
   seconds_to_human_time(time_precomp_str, sizeof(time_precomp_str), time_precomp);
   seconds_to_human_time(time_io_str, sizeof(time_io_str), time_io);
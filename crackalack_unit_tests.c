@@ -32,6 +32,7 @@
 #include "test_hash_to_index_ntlm9.h"
 #include "test_index_to_plaintext.h"
 #include "test_index_to_plaintext_ntlm9.h"
+#include "test_rt_search.h"
 #include "version.h"
 
 
@@ -100,9 +101,19 @@ int main(int ac, char **av) {
   */
 
 
+  /* Table search tests (CPU only). */
+  printf("Running table search tests... "); fflush(stdout);
+  if (!test_rt_search()) {
+    ret = -1;
+    all_tests_passed = 0;
+    PRINT_FAILED();
+  } else
+    PRINT_PASSED();
+
+
   /* index_to_plaintext() tests. */
   hash_type = HASH_NTLM;
-  load_kernel(context, num_devices, devices, "test_index_to_plaintext.cl", "test_index_to_plaintext", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_index_to_plaintext.cl", "test_index_to_plaintext", &program, &kernel, hash_type, NULL);
   printf("Running NTLM index_to_plaintext() tests... "); fflush(stdout);
   if (!test_index_to_plaintext(devices[0], context, kernel)) {
     ret = -1;
@@ -116,7 +127,7 @@ int main(int ac, char **av) {
 
 
   /* index_to_plaintext_ntlm9() tests. */
-  load_kernel(context, num_devices, devices, "test_index_to_plaintext_ntlm9.cl", "test_index_to_plaintext_ntlm9", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_index_to_plaintext_ntlm9.cl", "test_index_to_plaintext_ntlm9", &program, &kernel, hash_type, NULL);
   printf("Running NTLM9 index_to_plaintext_ntlm9() tests... "); fflush(stdout);
   if (!test_index_to_plaintext_ntlm9(devices[0], context, kernel)) {
     ret = -1;
@@ -133,7 +144,7 @@ int main(int ac, char **av) {
   /*
   printf("Running LM hash tests... "); fflush(stdout);
   hash_type = HASH_LM;
-  load_kernel(context, num_devices, devices, "test_hash.cl", "test_hash", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_hash.cl", "test_hash", &program, &kernel, hash_type, NULL);
   if (!test_hash(devices[0], context, kernel, hash_type)) {
     ret = -1;
     all_tests_passed = 0;
@@ -145,10 +156,20 @@ int main(int ac, char **av) {
   CLRELEASEPROGRAM(program);
   */
 
+  /* The LM GPU tests above stay disabled, but the CPU's bitsliced DES is checked
+   * against the same test vectors. */
+  printf("Running LM hash tests (CPU only)... "); fflush(stdout);
+  if (!test_hash_lm_cpu()) {
+    ret = -1;
+    all_tests_passed = 0;
+    PRINT_FAILED();
+  } else
+    PRINT_PASSED();
+
   
   printf("Running NTLM hash tests... "); fflush(stdout);
   hash_type = HASH_NTLM;
-  load_kernel(context, num_devices, devices, "test_hash.cl", "test_hash", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_hash.cl", "test_hash", &program, &kernel, hash_type, NULL);
   if (!test_hash(devices[0], context, kernel, hash_type)) {
     ret = -1;
     all_tests_passed = 0;
@@ -161,7 +182,7 @@ int main(int ac, char **av) {
 
 
   printf("Running NTLM9 hash tests... "); fflush(stdout);
-  load_kernel(context, num_devices, devices, "test_hash_ntlm9.cl", "test_hash_ntlm9", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_hash_ntlm9.cl", "test_hash_ntlm9", &program, &kernel, hash_type, NULL);
   if (!test_hash_ntlm9(devices[0], context, kernel)) {
     ret = -1;
     all_tests_passed = 0;
@@ -173,11 +194,39 @@ int main(int ac, char **av) {
   CLRELEASEPROGRAM(program);
 
 
+  printf("Running MD5 hash tests... "); fflush(stdout);
+  hash_type = HASH_MD5;
+  load_kernel(context, num_devices, devices, "test_hash.cl", "test_hash", &program, &kernel, hash_type, NULL);
+  if (!test_hash(devices[0], context, kernel, hash_type)) {
+    ret = -1;
+    all_tests_passed = 0;
+    PRINT_FAILED();
+  } else
+    PRINT_PASSED();
+
+  CLRELEASEKERNEL(kernel);
+  CLRELEASEPROGRAM(program);
+
+
+  printf("Running SHA-1 hash tests... "); fflush(stdout);
+  hash_type = HASH_SHA1;
+  load_kernel(context, num_devices, devices, "test_hash.cl", "test_hash", &program, &kernel, hash_type, NULL);
+  if (!test_hash(devices[0], context, kernel, hash_type)) {
+    ret = -1;
+    all_tests_passed = 0;
+    PRINT_FAILED();
+  } else
+    PRINT_PASSED();
+
+  CLRELEASEKERNEL(kernel);
+  CLRELEASEPROGRAM(program);
+
+
   /* hash_to_index() tests. */
   /*
   printf("Running LM hash_to_index() tests... "); fflush(stdout);
   hash_type = HASH_LM;
-  load_kernel(context, num_devices, devices, "test_hash_to_index.cl", "test_hash_to_index", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_hash_to_index.cl", "test_hash_to_index", &program, &kernel, hash_type, NULL);
   if (!test_h2i(devices[0], context, kernel, hash_type)) {
     ret = -1;
     all_tests_passed = 0;
@@ -191,7 +240,7 @@ int main(int ac, char **av) {
 
   printf("Running NTLM hash_to_index() tests... "); fflush(stdout);
   hash_type = HASH_NTLM;
-  load_kernel(context, num_devices, devices, "test_hash_to_index.cl", "test_hash_to_index", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_hash_to_index.cl", "test_hash_to_index", &program, &kernel, hash_type, NULL);
   if (!test_h2i(devices[0], context, kernel, hash_type)) {
     ret = -1;
     all_tests_passed = 0;
@@ -204,7 +253,7 @@ int main(int ac, char **av) {
 
 
   printf("Running NTLM9 hash_to_index() tests... "); fflush(stdout);
-  load_kernel(context, num_devices, devices, "test_hash_to_index_ntlm9.cl", "test_hash_to_index_ntlm9", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_hash_to_index_ntlm9.cl", "test_hash_to_index_ntlm9", &program, &kernel, hash_type, NULL);
   if (!test_h2i_ntlm9(devices[0], context, kernel)) {
     ret = -1;
     all_tests_passed = 0;
@@ -220,7 +269,7 @@ int main(int ac, char **av) {
   /*
   printf("Running LM chain tests... "); fflush(stdout);
   hash_type = HASH_LM;
-  load_kernel(context, num_devices, devices, "test_chain.cl", "test_chain", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_chain.cl", "test_chain", &program, &kernel, hash_type, NULL);
   if (!test_chain(devices[0], context, kernel, hash_type)) {
     ret = -1;
     all_tests_passed = 0;
@@ -232,10 +281,18 @@ int main(int ac, char **av) {
   CLRELEASEPROGRAM(program);
   */
 
+  printf("Running LM chain tests (CPU only)... "); fflush(stdout);
+  if (!test_chain_lm_cpu()) {
+    ret = -1;
+    all_tests_passed = 0;
+    PRINT_FAILED();
+  } else
+    PRINT_PASSED();
+
 
   printf("Running NTLM chain tests... "); fflush(stdout);
   hash_type = HASH_NTLM;
-  load_kernel(context, num_devices, devices, "test_chain.cl", "test_chain", &program, &kernel, hash_type);
+  load_kernel(context, num_devices, devices, "test_chain.cl", "test_chain", &program, &kernel, hash_type, NULL);
   if (!test_chain(devices[0], context, kernel, hash_type)) {
     ret = -1;
     all_tests_passed = 0;
@@ -249,8 +306,8 @@ int main(int ac, char **av) {
 
   printf("Running NTLM9 chain tests... "); fflush(stdout);
   hash_type = HASH_NTLM;
-  /*load_kernel(context, num_devices, devices, "test_chain_ntlm9.cl", "test_chain_ntlm9", &program, &kernel, hash_type);*/
-  load_kernel(context, num_devices, devices, "crackalack_ntlm9.cl", "crackalack_ntlm9", &program, &kernel, hash_type);
+  /*load_kernel(context, num_devices, devices, "test_chain_ntlm9.cl", "test_chain_ntlm9", &program, &kernel, hash_type, NULL);*/
+  load_kernel(context, num_devices, devices, "crackalack.cl", "crackalack", &program, &kernel, hash_type, "-DNTLM_FIXED_LEN=9");
   if (!test_chain_ntlm9(devices[0], context, kernel)) {
     ret = -1;
     all_tests_passed = 0;
@@ -0,0 +1,265 @@
+/*
+ * Rainbow Crackalack: des_bs.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* A bitsliced DES for calculating LM hashes on the CPU.  Each bit of a word holds a
+ * different plaintext, so 64 (scalar), 256 (AVX2), or 512 (AVX-512) hashes are
+ * calculated at once.  The S-boxes (opencl_sboxes-s.h) and the rounds
+ * (des_bs_rounds.h) are the same ones that CL/des_bs.cl uses. */
+
+#include <string.h>
+
+#include "des_bs.h"
+#include "shared.h"
+
+
+/* The "KGS!@#$%" plaintext after the initial permutation, one bit per block entry. */
+static const unsigned char lm_block_bits[64] = {
+  0, 0, 0, 0, 0, 0, 0, 0,
+  1, 1, 1, 0, 1, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 1,
+  0, 0, 1, 0, 0, 1, 1, 1,
+  0, 0, 0, 1, 0, 1, 1, 1,
+  0, 0, 0, 0, 0, 1, 0, 0,
+  1, 1, 0, 0, 0, 0, 1, 0,
+  1, 0, 1, 0, 1, 1, 1, 1
+};
+
+/* Bit i of the hash (taken as a little-endian 64-bit integer) is found in entry
+ * lm_hash_bits[i] of the block after the last round.  This combines the final
+ * permutation with the bit reversal of each output byte that DES_bs_get_source_LM()
+ * in CL/des_bs.cl does. */
+static const unsigned char lm_hash_bits[64] = {
+  31, 63, 23, 55, 15, 47, 7, 39,
+  30, 62, 22, 54, 14, 46, 6, 38,
+  29, 61, 21, 53, 13, 45, 5, 37,
+  28, 60, 20, 52, 12, 44, 4, 36,
+  27, 59, 19, 51, 11, 43, 3, 35,
+  26, 58, 18, 50, 10, 42, 2, 34,
+  25, 57, 17, 49, 9, 41, 1, 33,
+  24, 56, 16, 48, 8, 40, 0, 32
+};
+
+
+/* The operations that the S-boxes and rounds are written in terms of. */
+#define vxorf(a, b) ((a) ^ (b))
+#define vnot(dst, a) (dst) = ~(a)
+#define vand(dst, a, b) (dst) = (a) & (b)
+#define vor(dst, a, b) (dst) = (a) | (b)
+#define vxor(dst, a, b) (dst) = vxorf((a), (b))
+#define vsel(dst, a, b, c) (dst) = (((a) & ~(c)) | ((b) & (c)))
+
+/* The S-box functions are written for OpenCL.  They are included below once per word
+ * type, and are renamed each time with the DES_BS_SUFFIX of that type (i.e.: s1()
+ * becomes s1_x64()). */
+#define __private
+#define inline static inline
+#define DES_BS_PASTE(_name, _suffix) _name ## _ ## _suffix
+#define DES_BS_NAME(_name, _suffix) DES_BS_PASTE(_name, _suffix)
+#define s1 DES_BS_NAME(s1, DES_BS_SUFFIX)
+#define s2 DES_BS_NAME(s2, DES_BS_SUFFIX)
+#define s3 DES_BS_NAME(s3, DES_BS_SUFFIX)
+#define s4 DES_BS_NAME(s4, DES_BS_SUFFIX)
+#define s5 DES_BS_NAME(s5, DES_BS_SUFFIX)
+#define s6 DES_BS_NAME(s6, DES_BS_SUFFIX)
+#define s7 DES_BS_NAME(s7, DES_BS_SUFFIX)
+#define s8 DES_BS_NAME(s8, DES_BS_SUFFIX)
+
+#include "des_bs_rounds.h"
+
+/* Encrypts the LM plaintext with the keys of all lanes.  Key bit i is in
+ * keys[(i * words) + word], and block entry i is stored in block[(i * words) + word],
+ * where word is the 64-bit part of the vector that a lane is in. */
+#define DES_BS_LM_ENCRYPT_BODY \
+  vtype B[64], lm_keys[56]; \
+  unsigned int i = 0; \
+  \
+  \
+  memcpy(lm_keys, keys, sizeof(lm_keys)); \
+  for (i = 0; i < 64; i++) \
+    memset(&(B[i]), lm_block_bits[i] ? 0xff : 0, sizeof(vtype)); \
+  \
+  H1_k0(); \
+  H2_k0(); \
+  H1_k1(); \
+  H2_k1(); \
+  H1_k2(); \
+  H2_k2(); \
+  H1_k3(); \
+  H2_k3(); \
+  H1_k4(); \
+  H2_k4(); \
+  H1_k5(); \
+  H2_k5(); \
+  H1_k6(); \
+  H2_k6(); \
+  H1_k7(); \
+  H2_k7(); \
+  \
+  memcpy(block, B, sizeof(B));
+
+
+#define vtype uint64_t
+#define DES_BS_SUFFIX x64
+#include "opencl_sboxes-s.h"
+
+static void des_bs_lm_encrypt_x64(uint64_t *keys, uint64_t *block) {
+  DES_BS_LM_ENCRYPT_BODY
+}
+
+#undef DES_BS_SUFFIX
+#undef vtype
+
+
+#ifdef CPU_SIMD_SUPPORTED
+typedef uint64_t v4du __attribute__((vector_size(32)));
+typedef uint64_t v8du __attribute__((vector_size(64)));
+
+/* The S-box functions can't be given target attributes individually, so the whole
+ * region is compiled for the instruction set instead. */
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define vtype v4du
+#define DES_BS_SUFFIX x256
+#include "opencl_sboxes-s.h"
+
+static void des_bs_lm_encrypt_x256(uint64_t *keys, uint64_t *block) {
+  DES_BS_LM_ENCRYPT_BODY
+}
+
+#undef DES_BS_SUFFIX
+#undef vtype
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define vtype v8du
+#define DES_BS_SUFFIX x512
+#include "opencl_sboxes-s.h"
+
+static void des_bs_lm_encrypt_x512(uint64_t *keys, uint64_t *block) {
+  DES_BS_LM_ENCRYPT_BODY
+}
+
+#undef DES_BS_SUFFIX
+#undef vtype
+#pragma GCC pop_options
+#endif /* CPU_SIMD_SUPPORTED */
+
+#undef inline
+#undef __private
+
+
+/* Transposes the 64x64 bit matrix m in place, i.e.: bit j of m[i] is exchanged with
+ * bit i of m[j].  This is done by swapping ever-smaller blocks, in 6 steps. */
+static void transpose64(uint64_t *m) {
+  uint64_t mask = 0x00000000ffffffffULL, t = 0;
+  unsigned int j = 0, k = 0;
+
+
+  for (j = 32; j != 0; j >>= 1, mask ^= (mask << j)) {
+    for (k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+      t = ((m[k] >> j) ^ m[k | j]) & mask;
+      m[k] ^= (t << j);
+      m[k | j] ^= t;
+    }
+  }
+}
+
+
+/* Calculates the LM hashes of up to (words * 64) plaintexts with one pass of the
+ * specified bitsliced encryption function. */
+static void lm_hash_lanes(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes, unsigned int words, void (*encrypt)(uint64_t *, uint64_t *)) {
+  uint64_t keys[56 * (DES_BS_LANES_AVX512 / 64)] = {0}, block[64 * (DES_BS_LANES_AVX512 / 64)], m[64];
+  unsigned int word = 0, lane = 0, i = 0, j = 0, len = 0;
+  char *plaintext = NULL;
+  unsigned char *hash = NULL;
+
+
+  /* Row i of the matrix is the key of lane i: bit j of plaintext character i is key bit
+   * (i * 8) + j, and plaintexts are zero-padded to 7 characters.  Transposing it gives
+   * each key bit across all 64 lanes. */
+  for (word = 0; (word * 64) < num_plaintexts; word++) {
+    for (lane = 0; lane < 64; lane++) {
+      m[lane] = 0;
+
+      i = (word * 64) + lane;
+      if (i >= num_plaintexts)
+	continue;
+
+      plaintext = plaintexts + (i * MAX_PLAINTEXT_LEN);
+      len = (plaintext_lens[i] < 7) ? plaintext_lens[i] : 7;
+      for (j = 0; j < len; j++)
+	m[lane] |= ((uint64_t)(unsigned char)plaintext[j] << (j * 8));
+    }
+
+    transpose64(m);
+    for (i = 0; i < 56; i++)
+      keys[(i * words) + word] = m[i];
+  }
+
+  encrypt(keys, block);
+
+  /* Gather the block bits into hash bit order, then transpose them back into one hash
+   * per row. */
+  for (word = 0; (word * 64) < num_plaintexts; word++) {
+    for (i = 0; i < 64; i++)
+      m[i] = block[(lm_hash_bits[i] * words) + word];
+
+    transpose64(m);
+    for (lane = 0; (lane < 64) && (((word * 64) + lane) < num_plaintexts); lane++) {
+      hash = hashes + (((word * 64) + lane) * MAX_HASH_OUTPUT_LEN);
+      for (i = 0; i < 8; i++)
+	hash[i] = (m[lane] >> (i * 8)) & 0xff;
+    }
+  }
+}
+
+
+/* Calculates the LM hashes of num_plaintexts plaintexts.  Plaintext i is read from
+ * &plaintexts[i * MAX_PLAINTEXT_LEN] with length plaintext_lens[i], and its 8-byte hash
+ * is written to &hashes[i * MAX_HASH_OUTPUT_LEN].  The widest pass that the SIMD level
+ * allows is used while enough plaintexts remain to fill more than the next narrower
+ * one. */
+void des_bs_lm_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes, unsigned int simd_level) {
+  unsigned int i = 0, lanes = 0, num_lanes = 0;
+
+
+  for (i = 0; i < num_plaintexts; i += num_lanes) {
+    num_lanes = num_plaintexts - i;
+
+#ifdef CPU_SIMD_SUPPORTED
+    if ((simd_level == SIMD_AVX512) && (num_lanes > DES_BS_LANES_AVX2)) {
+      lanes = DES_BS_LANES_AVX512;
+      if (num_lanes > lanes)
+	num_lanes = lanes;
+      lm_hash_lanes(plaintexts + (i * MAX_PLAINTEXT_LEN), plaintext_lens + i, num_lanes, hashes + (i * MAX_HASH_OUTPUT_LEN), lanes / 64, des_bs_lm_encrypt_x512);
+      continue;
+    } else if ((simd_level != SIMD_SCALAR) && (num_lanes > DES_BS_LANES_SCALAR)) {
+      lanes = DES_BS_LANES_AVX2;
+      if (num_lanes > lanes)
+	num_lanes = lanes;
+      lm_hash_lanes(plaintexts + (i * MAX_PLAINTEXT_LEN), plaintext_lens + i, num_lanes, hashes + (i * MAX_HASH_OUTPUT_LEN), lanes / 64, des_bs_lm_encrypt_x256);
+      continue;
+    }
+#endif
+
+    lanes = DES_BS_LANES_SCALAR;
+    if (num_lanes > lanes)
+      num_lanes = lanes;
+    lm_hash_lanes(plaintexts + (i * MAX_PLAINTEXT_LEN), plaintext_lens + i, num_lanes, hashes + (i * MAX_HASH_OUTPUT_LEN), lanes / 64, des_bs_lm_encrypt_x64);
+  }
+}
@@ -0,0 +1,17 @@
+#ifndef _DES_BS_H
+#define _DES_BS_H
+
+#include <stdint.h>
+
+#include "cpu_features.h"
+
+/* The number of plaintexts that one pass of the bitsliced DES processes at each SIMD
+ * level: one per bit of a 64-, 256-, or 512-bit word. */
+#define DES_BS_LANES_SCALAR 64
+#define DES_BS_LANES_AVX2   256
+#define DES_BS_LANES_AVX512 512
+
+
+void des_bs_lm_hash_many(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes, unsigned int simd_level);
+
+#endif
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "cpu_rt_functions.h"
+#include "shared.h"
 #include "test_shared.h"
 
 
@@ -36,6 +37,7 @@ int main(int ac, char **av) {
   char plaintext[16] = {0}, hash_hex[48] = {0};
   unsigned char hash[16] = {0};
   unsigned int plaintext_len = 0, chain_len = 0, hash_len = 16, pos = 0;
+  reduction_context rc;
 
 
   if (ac != 5) {
@@ -56,17 +58,20 @@ int main(int ac, char **av) {
 
   plaintext_space_total = fill_plaintext_space_table(CHARSET_LEN, plaintext_len, plaintext_len, plaintext_space_up_to_index);
 
+  /* The charset is always ascii-32-95, so the specialized NTLM8/NTLM9 step functions
+   * are used. */
+  init_reduction_context(&rc, HASH_NTLM, charset, CHARSET_LEN, plaintext_len, plaintext_len, plaintext_space_total);
   printf("Position   Plaintext   Hash   Hash Index\n");
   for (pos = 0; pos < chain_len - 1; pos++) {
-    index_to_plaintext(index, charset, CHARSET_LEN, plaintext_len, plaintext_len, plaintext_space_up_to_index, plaintext, &plaintext_len);
-    ntlm_hash(plaintext, plaintext_len, hash);
+    step_index_to_plaintext(&rc, index, charset, plaintext_len, plaintext_len, plaintext_space_up_to_index, plaintext, &plaintext_len);
+    rc.hp->hash(plaintext, plaintext_len, hash);
 
     if (!bytes_to_hex(hash, hash_len, hash_hex, sizeof(hash_hex))) {
       fprintf(stderr, "Error while converting bytes to hex.\n");
       return -1;
     }
 
-    index = hash_to_index(hash, hash_len, 0, plaintext_space_total, pos);
+    index = step_hash_to_index(&rc, hash, 0, pos);
     printf("%u  %s  %s  %"PRIu64"\n", pos, plaintext, hash_hex, index);
   }
 
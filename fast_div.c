@@ -0,0 +1,73 @@
+/*
+ * Rainbow Crackalack: fast_div.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fast_div.h"
+
+
+/* Computes the multiply/shift constants for the specified divisor.  The divisor must
+ * not be zero. */
+void fast_div_init(fast_div *fd, uint64_t divisor) {
+  uint64_t proposed_magic = 0, remainder = 0, carry = 0;
+  unsigned int floor_log2 = 63;
+  int i = 0;
+
+
+  if (divisor == 0) {
+    fprintf(stderr, "Error: fast_div_init() called with a divisor of zero!\n");
+    exit(-1);
+  }
+
+  while ((divisor >> floor_log2) == 0)
+    floor_log2--;
+
+  fd->divisor = divisor;
+  fd->magic = 0;
+  fd->shift = floor_log2;
+  fd->add = 0;
+
+  /* Powers of two are a plain shift. */
+  if ((divisor & (divisor - 1)) == 0)
+    return;
+
+  /* Long division of 2^(64 + floor_log2) by the divisor.  The upper 64 bits of the
+   * dividend (2^floor_log2) are less than the divisor, so the quotient fits in 64 bits.
+   * This is done bit by bit so that it is identical to the OpenCL version. */
+  remainder = (uint64_t)1 << floor_log2;
+  for (i = 0; i < 64; i++) {
+    carry = remainder >> 63;
+    remainder <<= 1;
+    proposed_magic <<= 1;
+    if (carry || (remainder >= divisor)) {
+      remainder -= divisor;
+      proposed_magic |= 1;
+    }
+  }
+
+  /* If 2^floor_log2 is large enough, the magic number fits in 64 bits.  Otherwise, use
+   * a 65-bit magic number; its implicit top bit is handled by the "add" step in
+   * fast_div_quotient(). */
+  if ((divisor - remainder) >= ((uint64_t)1 << floor_log2)) {
+    proposed_magic += proposed_magic;
+    if (((remainder + remainder) >= divisor) || ((remainder + remainder) < remainder))
+      proposed_magic++;
+    fd->add = 1;
+  }
+  fd->magic = proposed_magic + 1;
+}
@@ -0,0 +1,45 @@
+#ifndef _FAST_DIV_H
+#define _FAST_DIV_H
+
+#include <stdint.h>
+
+/* Pre-computed constants for dividing 64-bit integers by a fixed divisor with a
+ * multiplication and a shift (see Granlund & Montgomery, "Division by Invariant
+ * Integers using Multiplication").  CL/fast_div.cl contains the same algorithm for
+ * the kernels. */
+struct _fast_div {
+  uint64_t divisor;
+  uint64_t magic;    /* 0 when the divisor is a power of two. */
+  unsigned int shift;
+  unsigned int add;  /* 1 when the magic number needed a 65th bit. */
+};
+typedef struct _fast_div fast_div;
+
+
+void fast_div_init(fast_div *fd, uint64_t divisor);
+
+
+/* These are called once per character in the chain walkers, so they are defined here
+ * in order for them to be inlined into other translation units. */
+
+/* Returns n / fd->divisor. */
+static inline uint64_t fast_div_quotient(uint64_t n, const fast_div *fd) {
+  uint64_t q = 0;
+
+
+  if (fd->magic == 0)
+    return n >> fd->shift;
+
+  q = (uint64_t)(((unsigned __int128)n * fd->magic) >> 64);
+  if (fd->add)
+    return (((n - q) >> 1) + q) >> fd->shift;
+  else
+    return q >> fd->shift;
+}
+
+/* Returns n % fd->divisor. */
+static inline uint64_t fast_div_remainder(uint64_t n, const fast_div *fd) {
+  return n - (fast_div_quotient(n, fd) * fd->divisor);
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Rainbow Crackalack: gpu_session.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* A per-device cache of the OpenCL context, programs, kernels, and queues.  A lookup
+ * only uses a handful of distinct kernels (one each for precomputation, false alarm
+ * checks, and table searches, built for the tables' parameters), so every kernel
+ * that is built is kept until the session is freed. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gpu_session.h"
+#include "misc.h"
+
+
+#define LOCK_SESSION(_gs) \
+  if (pthread_mutex_lock(&((_gs)->lock))) { perror("Failed to lock mutex"); exit(-1); }
+
+#define UNLOCK_SESSION(_gs) \
+  if (pthread_mutex_unlock(&((_gs)->lock))) { perror("Failed to unlock mutex"); exit(-1); }
+
+
+/* Returns 1 if two optional strings are the same (or both NULL), otherwise 0. */
+static int optional_strings_equal(const char *a, const char *b) {
+  if ((a == NULL) || (b == NULL))
+    return a == b;
+  return strcmp(a, b) == 0;
+}
+
+
+void gpu_session_init(gpu_session *gs, cl_device_id device) {
+  gs->device = device;
+  gs->context = NULL;
+  gs->kernels = NULL;
+
+  if (pthread_mutex_init(&(gs->lock), NULL)) {
+    perror("Failed to create mutex");
+    exit(-1);
+  }
+}
+
+
+/* Sets the context, program, kernel, and queue for the given kernel on this session's
+ * device, building it the first time it is asked for.  These belong to the session,
+ * so the caller must not release them.  The caller must also not use the same kernel
+ * from more than one thread at once, since its arguments are shared. */
+void gpu_session_get_kernel(gpu_session *gs, const char *source_filename, const char *kernel_name, unsigned int hash_type, const char *build_options, cl_context *context, cl_program *program, cl_kernel *kernel, cl_command_queue *queue) {
+  gpu_session_kernel *gsk = NULL;
+  int err = 0;
+
+
+  LOCK_SESSION(gs);
+
+  if (gs->context == NULL) {
+    gs->context = CLCREATECONTEXT(context_callback, &(gs->device));
+  }
+
+  for (gsk = gs->kernels; gsk != NULL; gsk = gsk->next) {
+    if ((gsk->hash_type == hash_type) && (strcmp(gsk->source_filename, source_filename) == 0) && (strcmp(gsk->kernel_name, kernel_name) == 0) && optional_strings_equal(gsk->build_options, build_options))
+      break;
+  }
+
+  /* This kernel hasn't been built yet, so build it now and add it to the cache. */
+  if (gsk == NULL) {
+    gsk = calloc(1, sizeof(gpu_session_kernel));
+    if (gsk == NULL) {
+      fprintf(stderr, "Error while allocating GPU session.\n");
+      exit(-1);
+    }
+
+    gsk->source_filename = strdup(source_filename);
+    gsk->kernel_name = strdup(kernel_name);
+    gsk->hash_type = hash_type;
+    gsk->build_options = (build_options != NULL) ? strdup(build_options) : NULL;
+    if ((gsk->source_filename == NULL) || (gsk->kernel_name == NULL) || ((build_options != NULL) && (gsk->build_options == NULL))) {
+      fprintf(stderr, "Error while allocating GPU session.\n");
+      exit(-1);
+    }
+
+    load_kernel(gs->context, 1, &(gs->device), source_filename, kernel_name, &(gsk->program), &(gsk->kernel), hash_type, build_options);
+    gsk->queue = CLCREATEQUEUE(gs->context, gs->device);
+
+    gsk->next = gs->kernels;
+    gs->kernels = gsk;
+  }
+
+  *context = gs->context;
+  *program = gsk->program;
+  *kernel = gsk->kernel;
+  *queue = gsk->queue;
+
+  UNLOCK_SESSION(gs);
+}
+
+
+/* Releases everything held by the session. */
+void gpu_session_free(gpu_session *gs) {
+  gpu_session_kernel *gsk = NULL;
+
+
+  LOCK_SESSION(gs);
+  while (gs->kernels != NULL) {
+    gsk = gs->kernels;
+    gs->kernels = gsk->next;
+
+    CLRELEASEKERNEL(gsk->kernel);
+    CLRELEASEPROGRAM(gsk->program);
+    CLRELEASEQUEUE(gsk->queue);
+    FREE(gsk->source_filename);
+    FREE(gsk->kernel_name);
+    FREE(gsk->build_options);
+    FREE(gsk);
+  }
+  CLRELEASECONTEXT(gs->context);
+  UNLOCK_SESSION(gs);
+
+  pthread_mutex_destroy(&(gs->lock));
+}
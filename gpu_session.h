@@ -0,0 +1,44 @@
+#ifndef _GPU_SESSION_H
+#define _GPU_SESSION_H
+
+#include <pthread.h>
+
+#include "opencl_setup.h"
+
+
+/* A program and kernel built for one device, along with the source and options it
+ * was built from (which are what it is looked up by). */
+struct _gpu_session_kernel {
+  char *source_filename;
+  char *kernel_name;
+  unsigned int hash_type;
+  char *build_options;  /* NULL if none. */
+
+  cl_program program;
+  cl_kernel kernel;
+  cl_command_queue queue;  /* Each kernel gets its own, so that different kernels
+			    * running on the same device don't wait on each other. */
+  struct _gpu_session_kernel *next;
+};
+typedef struct _gpu_session_kernel gpu_session_kernel;
+
+
+/* Holds the OpenCL context of one device, and every kernel built for it, for the
+ * life of the process.  Creating a context and compiling a kernel's source can take
+ * longer than the kernel then runs, so this is done once rather than for every hash
+ * and every table. */
+struct _gpu_session {
+  cl_device_id device;
+  cl_context context;  /* Created on first use. */
+
+  pthread_mutex_t lock;
+  gpu_session_kernel *kernels;
+};
+typedef struct _gpu_session gpu_session;
+
+
+void gpu_session_init(gpu_session *gs, cl_device_id device);
+void gpu_session_get_kernel(gpu_session *gs, const char *source_filename, const char *kernel_name, unsigned int hash_type, const char *build_options, cl_context *context, cl_program *program, cl_kernel *kernel, cl_command_queue *queue);
+void gpu_session_free(gpu_session *gs);
+
+#endif
@@ -0,0 +1,46 @@
+/*
+ * Rainbow Crackalack: hash_provider.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+
+#include "cpu_rt_functions.h"
+#include "hash_provider.h"
+#include "shared.h"
+
+
+/* The hash algorithms that have a CPU implementation.  To add one, implement its
+ * hash() and hash_many() functions and append an entry here. */
+static const hash_provider hash_providers[] = {
+  {HASH_LM, "lm", 8, lm_hash, lm_hash_many, hash_to_index_fast_div},
+  {HASH_NTLM, "ntlm", 16, ntlm_hash, ntlm_hash_many, hash_to_index_fast_div},
+  {HASH_MD5, "md5", 16, md5_hash, md5_hash_many, hash_to_index_fast_div},
+  {HASH_SHA1, "sha1", 20, sha1_hash, sha1_hash_many, hash_to_index_fast_div},
+};
+
+
+/* Returns the CPU implementation of the specified hash type, or NULL if there is
+ * none. */
+const hash_provider *get_hash_provider(unsigned int hash_type) {
+  unsigned int i = 0;
+
+
+  for (i = 0; i < (sizeof(hash_providers) / sizeof(hash_provider)); i++) {
+    if (hash_providers[i].hash_type == hash_type)
+      return &(hash_providers[i]);
+  }
+  return NULL;
+}
@@ -0,0 +1,32 @@
+#ifndef _HASH_PROVIDER_H
+#define _HASH_PROVIDER_H
+
+#include <stdint.h>
+
+#include "fast_div.h"
+
+/* The CPU implementation of a hash algorithm.  The chain walkers look this up once per
+ * table (see get_hash_provider()), so that their inner loops need not branch on the
+ * hash type. */
+struct _hash_provider {
+  unsigned int hash_type;  /* One of the HASH_* values in shared.h. */
+  char *name;
+  unsigned int hash_len;   /* The digest length, in bytes. */
+
+  /* Hashes one plaintext. */
+  void (*hash)(char *plaintext, unsigned int plaintext_len, unsigned char *hash);
+
+  /* Hashes num_plaintexts plaintexts, each MAX_PLAINTEXT_LEN bytes apart, into hashes,
+   * each MAX_HASH_OUTPUT_LEN bytes apart.  The results must be identical to calling
+   * hash() on each plaintext. */
+  void (*hash_many)(char *plaintexts, unsigned int *plaintext_lens, unsigned int num_plaintexts, unsigned char *hashes);
+
+  /* Reduces a digest to a plaintext index. */
+  uint64_t (*hash_to_index)(unsigned char *hash_value, unsigned int reduction_offset, const fast_div *plaintext_space_total_div, unsigned int pos);
+};
+typedef struct _hash_provider hash_provider;
+
+
+const hash_provider *get_hash_provider(unsigned int hash_type);
+
+#endif
@@ -28,6 +28,10 @@ cl_uint hash_str_to_type(char *hash_str) {
     ret = HASH_LM;
   else if (strcmp(hash_str, "ntlm") == 0)
     ret = HASH_NTLM;
+  else if (strcmp(hash_str, "md5") == 0)
+    ret = HASH_MD5;
+  else if (strcmp(hash_str, "sha1") == 0)
+    ret = HASH_SHA1;
 
   return ret;
 }
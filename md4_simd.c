@@ -0,0 +1,127 @@
+/*
+ * Rainbow Crackalack: md4_simd.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Multi-buffer MD4: each SIMD lane computes an independent, single-block MD4 digest.
+ * The message words and results are transposed, so that W[(i * lanes) + lane] holds
+ * word i of the given lane's block, and hash[(i * lanes) + lane] holds word i of its
+ * digest.  The round structure matches md4_encrypt() in cpu_rt_functions.c exactly.
+ */
+
+#include <string.h>
+
+#include "md4_simd.h"
+
+#ifdef CPU_SIMD_SUPPORTED
+
+typedef unsigned int v8ui __attribute__((vector_size(32)));
+typedef unsigned int v16ui __attribute__((vector_size(64)));
+
+#define F(x, y, z)	(z ^ (x & (y ^ z)))
+#define G(x, y, z)	(((x) & ((y) | (z))) | ((y) & (z)))
+#define H(x, y, z)	(((x) ^ (y)) ^ (z))
+#define H2(x, y, z)	((x) ^ ((y) ^ (z)))
+
+#define STEP(f, a, b, c, d, x, s)	  \
+	(a) += f((b), (c), (d)) + (x); \
+	(a) = ((a << s) | (a >> (32 - s)))
+
+/* All three MD4 rounds over the state (a, b, c, d) and message words W. */
+#define MD4_ROUNDS(a, b, c, d, W) \
+	STEP(F, a, b, c, d, W[0], 3); \
+	STEP(F, d, a, b, c, W[1], 7); \
+	STEP(F, c, d, a, b, W[2], 11); \
+	STEP(F, b, c, d, a, W[3], 19); \
+	STEP(F, a, b, c, d, W[4], 3); \
+	STEP(F, d, a, b, c, W[5], 7); \
+	STEP(F, c, d, a, b, W[6], 11); \
+	STEP(F, b, c, d, a, W[7], 19); \
+	STEP(F, a, b, c, d, W[8], 3); \
+	STEP(F, d, a, b, c, W[9], 7); \
+	STEP(F, c, d, a, b, W[10], 11); \
+	STEP(F, b, c, d, a, W[11], 19); \
+	STEP(F, a, b, c, d, W[12], 3); \
+	STEP(F, d, a, b, c, W[13], 7); \
+	STEP(F, c, d, a, b, W[14], 11); \
+	STEP(F, b, c, d, a, W[15], 19); \
+	\
+	STEP(G, a, b, c, d, W[0] + 0x5a827999, 3); \
+	STEP(G, d, a, b, c, W[4] + 0x5a827999, 5); \
+	STEP(G, c, d, a, b, W[8] + 0x5a827999, 9); \
+	STEP(G, b, c, d, a, W[12] + 0x5a827999, 13); \
+	STEP(G, a, b, c, d, W[1] + 0x5a827999, 3); \
+	STEP(G, d, a, b, c, W[5] + 0x5a827999, 5); \
+	STEP(G, c, d, a, b, W[9] + 0x5a827999, 9); \
+	STEP(G, b, c, d, a, W[13] + 0x5a827999, 13); \
+	STEP(G, a, b, c, d, W[2] + 0x5a827999, 3); \
+	STEP(G, d, a, b, c, W[6] + 0x5a827999, 5); \
+	STEP(G, c, d, a, b, W[10] + 0x5a827999, 9); \
+	STEP(G, b, c, d, a, W[14] + 0x5a827999, 13); \
+	STEP(G, a, b, c, d, W[3] + 0x5a827999, 3); \
+	STEP(G, d, a, b, c, W[7] + 0x5a827999, 5); \
+	STEP(G, c, d, a, b, W[11] + 0x5a827999, 9); \
+	STEP(G, b, c, d, a, W[15] + 0x5a827999, 13); \
+	\
+	STEP(H, a, b, c, d, W[0] + 0x6ed9eba1, 3); \
+	STEP(H2, d, a, b, c, W[8] + 0x6ed9eba1, 9); \
+	STEP(H, c, d, a, b, W[4] + 0x6ed9eba1, 11); \
+	STEP(H2, b, c, d, a, W[12] + 0x6ed9eba1, 15); \
+	STEP(H, a, b, c, d, W[2] + 0x6ed9eba1, 3); \
+	STEP(H2, d, a, b, c, W[10] + 0x6ed9eba1, 9); \
+	STEP(H, c, d, a, b, W[6] + 0x6ed9eba1, 11); \
+	STEP(H2, b, c, d, a, W[14] + 0x6ed9eba1, 15); \
+	STEP(H, a, b, c, d, W[1] + 0x6ed9eba1, 3); \
+	STEP(H2, d, a, b, c, W[9] + 0x6ed9eba1, 9); \
+	STEP(H, c, d, a, b, W[5] + 0x6ed9eba1, 11); \
+	STEP(H2, b, c, d, a, W[13] + 0x6ed9eba1, 15); \
+	STEP(H, a, b, c, d, W[3] + 0x6ed9eba1, 3); \
+	STEP(H2, d, a, b, c, W[11] + 0x6ed9eba1, 9); \
+	STEP(H, c, d, a, b, W[7] + 0x6ed9eba1, 11); \
+	STEP(H2, b, c, d, a, W[15] + 0x6ed9eba1, 15);
+
+/* Defines a multi-buffer MD4 function for the given vector type. */
+#define MD4_ENCRYPT_X(func_name, target_name, vtype, lanes) \
+__attribute__((target(target_name))) \
+void func_name(unsigned int *hash, unsigned int *W) { \
+  vtype w[16], a, b, c, d; \
+  int i = 0; \
+  \
+  for (i = 0; i < 16; i++) \
+    memcpy(&w[i], W + (i * lanes), sizeof(vtype)); \
+  \
+  a = (vtype){0} + 0x67452301; \
+  b = (vtype){0} + 0xefcdab89; \
+  c = (vtype){0} + 0x98badcfe; \
+  d = (vtype){0} + 0x10325476; \
+  \
+  MD4_ROUNDS(a, b, c, d, w); \
+  \
+  a += 0x67452301; \
+  b += 0xefcdab89; \
+  c += 0x98badcfe; \
+  d += 0x10325476; \
+  \
+  memcpy(hash + (0 * lanes), &a, sizeof(vtype)); \
+  memcpy(hash + (1 * lanes), &b, sizeof(vtype)); \
+  memcpy(hash + (2 * lanes), &c, sizeof(vtype)); \
+  memcpy(hash + (3 * lanes), &d, sizeof(vtype)); \
+}
+
+MD4_ENCRYPT_X(md4_encrypt_x8, "avx2", v8ui, 8)
+MD4_ENCRYPT_X(md4_encrypt_x16, "avx512f", v16ui, 16)
+
+#endif /* CPU_SIMD_SUPPORTED */
@@ -0,0 +1,11 @@
+#ifndef _MD4_SIMD_H
+#define _MD4_SIMD_H
+
+#include "cpu_features.h"
+
+#ifdef CPU_SIMD_SUPPORTED
+void md4_encrypt_x8(unsigned int *hash, unsigned int *W);
+void md4_encrypt_x16(unsigned int *hash, unsigned int *W);
+#endif
+
+#endif
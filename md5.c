@@ -0,0 +1,158 @@
+/*
+ * Rainbow Crackalack: md5.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Single-block MD5 (RFC 1321), in scalar and multi-buffer SIMD forms.  As in
+ * md4_simd.c, the multi-buffer versions take their message words and return their
+ * results transposed: W[(i * lanes) + lane] holds word i of the given lane's block,
+ * and hash[(i * lanes) + lane] holds word i of its digest.  The scalar version is
+ * the same code with one lane.
+ */
+
+#include <string.h>
+
+#include "md5.h"
+
+#define MD5_F(x, y, z)	((z) ^ ((x) & ((y) ^ (z))))
+#define MD5_G(x, y, z)	((y) ^ ((z) & ((x) ^ (y))))
+#define MD5_H(x, y, z)	((x) ^ (y) ^ (z))
+#define MD5_I(x, y, z)	((y) ^ ((x) | ~(z)))
+
+#define MD5_STEP(f, a, b, c, d, x, t, s) \
+	(a) += f((b), (c), (d)) + (x) + (t); \
+	(a) = (((a) << (s)) | ((a) >> (32 - (s)))); \
+	(a) += (b)
+
+/* All four MD5 rounds over the state (a, b, c, d) and message words W. */
+#define MD5_ROUNDS(a, b, c, d, W) \
+	MD5_STEP(MD5_F, a, b, c, d, W[0], 0xd76aa478, 7); \
+	MD5_STEP(MD5_F, d, a, b, c, W[1], 0xe8c7b756, 12); \
+	MD5_STEP(MD5_F, c, d, a, b, W[2], 0x242070db, 17); \
+	MD5_STEP(MD5_F, b, c, d, a, W[3], 0xc1bdceee, 22); \
+	MD5_STEP(MD5_F, a, b, c, d, W[4], 0xf57c0faf, 7); \
+	MD5_STEP(MD5_F, d, a, b, c, W[5], 0x4787c62a, 12); \
+	MD5_STEP(MD5_F, c, d, a, b, W[6], 0xa8304613, 17); \
+	MD5_STEP(MD5_F, b, c, d, a, W[7], 0xfd469501, 22); \
+	MD5_STEP(MD5_F, a, b, c, d, W[8], 0x698098d8, 7); \
+	MD5_STEP(MD5_F, d, a, b, c, W[9], 0x8b44f7af, 12); \
+	MD5_STEP(MD5_F, c, d, a, b, W[10], 0xffff5bb1, 17); \
+	MD5_STEP(MD5_F, b, c, d, a, W[11], 0x895cd7be, 22); \
+	MD5_STEP(MD5_F, a, b, c, d, W[12], 0x6b901122, 7); \
+	MD5_STEP(MD5_F, d, a, b, c, W[13], 0xfd987193, 12); \
+	MD5_STEP(MD5_F, c, d, a, b, W[14], 0xa679438e, 17); \
+	MD5_STEP(MD5_F, b, c, d, a, W[15], 0x49b40821, 22); \
+	 \
+	MD5_STEP(MD5_G, a, b, c, d, W[1], 0xf61e2562, 5); \
+	MD5_STEP(MD5_G, d, a, b, c, W[6], 0xc040b340, 9); \
+	MD5_STEP(MD5_G, c, d, a, b, W[11], 0x265e5a51, 14); \
+	MD5_STEP(MD5_G, b, c, d, a, W[0], 0xe9b6c7aa, 20); \
+	MD5_STEP(MD5_G, a, b, c, d, W[5], 0xd62f105d, 5); \
+	MD5_STEP(MD5_G, d, a, b, c, W[10], 0x02441453, 9); \
+	MD5_STEP(MD5_G, c, d, a, b, W[15], 0xd8a1e681, 14); \
+	MD5_STEP(MD5_G, b, c, d, a, W[4], 0xe7d3fbc8, 20); \
+	MD5_STEP(MD5_G, a, b, c, d, W[9], 0x21e1cde6, 5); \
+	MD5_STEP(MD5_G, d, a, b, c, W[14], 0xc33707d6, 9); \
+	MD5_STEP(MD5_G, c, d, a, b, W[3], 0xf4d50d87, 14); \
+	MD5_STEP(MD5_G, b, c, d, a, W[8], 0x455a14ed, 20); \
+	MD5_STEP(MD5_G, a, b, c, d, W[13], 0xa9e3e905, 5); \
+	MD5_STEP(MD5_G, d, a, b, c, W[2], 0xfcefa3f8, 9); \
+	MD5_STEP(MD5_G, c, d, a, b, W[7], 0x676f02d9, 14); \
+	MD5_STEP(MD5_G, b, c, d, a, W[12], 0x8d2a4c8a, 20); \
+	 \
+	MD5_STEP(MD5_H, a, b, c, d, W[5], 0xfffa3942, 4); \
+	MD5_STEP(MD5_H, d, a, b, c, W[8], 0x8771f681, 11); \
+	MD5_STEP(MD5_H, c, d, a, b, W[11], 0x6d9d6122, 16); \
+	MD5_STEP(MD5_H, b, c, d, a, W[14], 0xfde5380c, 23); \
+	MD5_STEP(MD5_H, a, b, c, d, W[1], 0xa4beea44, 4); \
+	MD5_STEP(MD5_H, d, a, b, c, W[4], 0x4bdecfa9, 11); \
+	MD5_STEP(MD5_H, c, d, a, b, W[7], 0xf6bb4b60, 16); \
+	MD5_STEP(MD5_H, b, c, d, a, W[10], 0xbebfbc70, 23); \
+	MD5_STEP(MD5_H, a, b, c, d, W[13], 0x289b7ec6, 4); \
+	MD5_STEP(MD5_H, d, a, b, c, W[0], 0xeaa127fa, 11); \
+	MD5_STEP(MD5_H, c, d, a, b, W[3], 0xd4ef3085, 16); \
+	MD5_STEP(MD5_H, b, c, d, a, W[6], 0x04881d05, 23); \
+	MD5_STEP(MD5_H, a, b, c, d, W[9], 0xd9d4d039, 4); \
+	MD5_STEP(MD5_H, d, a, b, c, W[12], 0xe6db99e5, 11); \
+	MD5_STEP(MD5_H, c, d, a, b, W[15], 0x1fa27cf8, 16); \
+	MD5_STEP(MD5_H, b, c, d, a, W[2], 0xc4ac5665, 23); \
+	 \
+	MD5_STEP(MD5_I, a, b, c, d, W[0], 0xf4292244, 6); \
+	MD5_STEP(MD5_I, d, a, b, c, W[7], 0x432aff97, 10); \
+	MD5_STEP(MD5_I, c, d, a, b, W[14], 0xab9423a7, 15); \
+	MD5_STEP(MD5_I, b, c, d, a, W[5], 0xfc93a039, 21); \
+	MD5_STEP(MD5_I, a, b, c, d, W[12], 0x655b59c3, 6); \
+	MD5_STEP(MD5_I, d, a, b, c, W[3], 0x8f0ccc92, 10); \
+	MD5_STEP(MD5_I, c, d, a, b, W[10], 0xffeff47d, 15); \
+	MD5_STEP(MD5_I, b, c, d, a, W[1], 0x85845dd1, 21); \
+	MD5_STEP(MD5_I, a, b, c, d, W[8], 0x6fa87e4f, 6); \
+	MD5_STEP(MD5_I, d, a, b, c, W[15], 0xfe2ce6e0, 10); \
+	MD5_STEP(MD5_I, c, d, a, b, W[6], 0xa3014314, 15); \
+	MD5_STEP(MD5_I, b, c, d, a, W[13], 0x4e0811a1, 21); \
+	MD5_STEP(MD5_I, a, b, c, d, W[4], 0xf7537e82, 6); \
+	MD5_STEP(MD5_I, d, a, b, c, W[11], 0xbd3af235, 10); \
+	MD5_STEP(MD5_I, c, d, a, b, W[2], 0x2ad7d2bb, 15); \
+	MD5_STEP(MD5_I, b, c, d, a, W[9], 0xeb86d391, 21);
+
+/* The body of an MD5 function for the given type (unsigned int or a vector of them). */
+#define MD5_ENCRYPT_BODY(vtype, lanes) \
+  vtype w[16], a, b, c, d; \
+  int i = 0; \
+  \
+  for (i = 0; i < 16; i++) \
+    memcpy(&w[i], W + (i * lanes), sizeof(vtype)); \
+  \
+  a = (vtype){0} + 0x67452301; \
+  b = (vtype){0} + 0xefcdab89; \
+  c = (vtype){0} + 0x98badcfe; \
+  d = (vtype){0} + 0x10325476; \
+  \
+  MD5_ROUNDS(a, b, c, d, w); \
+  \
+  a += 0x67452301; \
+  b += 0xefcdab89; \
+  c += 0x98badcfe; \
+  d += 0x10325476; \
+  \
+  memcpy(hash + (0 * lanes), &a, sizeof(vtype)); \
+  memcpy(hash + (1 * lanes), &b, sizeof(vtype)); \
+  memcpy(hash + (2 * lanes), &c, sizeof(vtype)); \
+  memcpy(hash + (3 * lanes), &d, sizeof(vtype));
+
+
+/* Runs the MD5 compression function on one block, starting from the standard
+ * initial state.  The four digest words are stored in hash. */
+void md5_encrypt(unsigned int *hash, unsigned int *W) {
+  MD5_ENCRYPT_BODY(unsigned int, 1)
+}
+
+
+#ifdef CPU_SIMD_SUPPORTED
+
+typedef unsigned int v8ui __attribute__((vector_size(32)));
+typedef unsigned int v16ui __attribute__((vector_size(64)));
+
+__attribute__((target("avx2")))
+void md5_encrypt_x8(unsigned int *hash, unsigned int *W) {
+  MD5_ENCRYPT_BODY(v8ui, 8)
+}
+
+__attribute__((target("avx512f")))
+void md5_encrypt_x16(unsigned int *hash, unsigned int *W) {
+  MD5_ENCRYPT_BODY(v16ui, 16)
+}
+
+#endif /* CPU_SIMD_SUPPORTED */
@@ -0,0 +1,13 @@
+#ifndef _MD5_H
+#define _MD5_H
+
+#include "cpu_features.h"
+
+void md5_encrypt(unsigned int *hash, unsigned int *W);
+
+#ifdef CPU_SIMD_SUPPORTED
+void md5_encrypt_x8(unsigned int *hash, unsigned int *W);
+void md5_encrypt_x16(unsigned int *hash, unsigned int *W);
+#endif
+
+#endif
@@ -104,6 +104,19 @@ char *get_os_name() {
 }
 
 
+/* Returns the number of CPU cores on this machine. */
+unsigned int get_num_cpu_cores() {
+#ifdef _WIN32
+  SYSTEM_INFO sysinfo = {0};
+
+  GetSystemInfo(&sysinfo);
+  return sysinfo.dwNumberOfProcessors;
+#else
+  return get_nprocs();
+#endif
+}
+
+
 /* Returns the amount of system RAM, in bytes.  Returns zero on error. */
 uint64_t get_total_memory() {
   uint64_t total_memory = 0;
@@ -210,7 +223,7 @@ unsigned int is_ntlm8(unsigned int hash_type, char *charset, unsigned int plaint
       (plaintext_len_min == 8) && \
       (plaintext_len_max == 8) && \
       (reduction_offset == 0) && \
-      (chain_len == 422000))
+      (chain_len == NTLM8_CHAIN_LEN))
     return 1;
   else
     return 0;
@@ -224,7 +237,7 @@ unsigned int is_ntlm9(unsigned int hash_type, char *charset, unsigned int plaint
       (plaintext_len_min == 9) && \
       (plaintext_len_max == 9) && \
       (reduction_offset == 0) && \
-      (chain_len == 803000))
+      (chain_len == NTLM9_CHAIN_LEN))
     return 1;
   else
     return 0;
@@ -45,7 +45,7 @@
 inline  void
 s1(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x0F0F3333, x3C3C3C3C, x55FF55FF, x69C369C3, x0903B73F, x09FCB7C0,
 	    x5CA9E295;
@@ -113,7 +113,7 @@ s1(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s1(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x0F0F3333, x3C3C3C3C, x55FF55FF, x69C369C3, x0903B73F, x09FCB7C0,
 	    x5CA9E295;
@@ -183,7 +183,7 @@ s1(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s2(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x55553333, x0055FF33, x33270F03, x66725A56, x00FFFF00, x668DA556;
 	vtype x0F0F5A56, xF0F0A5A9, xA5A5969A, xA55A699A;
@@ -247,7 +247,7 @@ s2(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s2(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x55553333, x0055FF33, x33270F03, x66725A56, x00FFFF00, x668DA556;
 	vtype x0F0F5A56, xF0F0A5A9, xA5A5969A, xA55A699A;
@@ -311,7 +311,7 @@ s2(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s2(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x55553333, x0055FF33, x33270F03, x66725A56, x00FFFF00, x668DA556;
 	vtype x0F0F5A56, xF0F0A5A9, xA5A5969A, xA55A699A;
@@ -377,7 +377,7 @@ s2(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s3(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x0F330F33, x0F33F0CC, x5A66A599;
 	vtype x2111B7BB, x03FF3033, x05BB50EE, x074F201F, x265E97A4;
@@ -440,7 +440,7 @@ s3(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s3(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x0F330F33, x0F33F0CC, x5A66A599;
 	vtype x2111B7BB, x03FF3033, x05BB50EE, x074F201F, x265E97A4;
@@ -505,7 +505,7 @@ s3(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s4(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x0505AFAF, x0555AF55, x0A5AA05A, x46566456, x0A0A5F5F, x0AF55FA0,
 	    x0AF50F0F, x4CA36B59;
@@ -559,7 +559,7 @@ s4(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s4(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x0505AFAF, x0555AF55, x0A5AA05A, x46566456, x0A0A5F5F, x0AF55FA0,
 	    x0AF50F0F, x4CA36B59;
@@ -615,7 +615,7 @@ s4(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x550F550F, xAAF0AAF0, xA5F5A5F5, x96C696C6, x00FFFF00, x963969C6;
 	vtype x2E3C2E3C, xB73121F7, x1501DF0F, x00558A5F, x2E69A463;
@@ -681,7 +681,7 @@ s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x550F550F, xAAF0AAF0, xA5F5A5F5, x96C696C6, x00FFFF00, x963969C6;
 	vtype x2E3C2E3C, xB73121F7, x1501DF0F, x00558A5F, x2E69A463;
@@ -747,7 +747,7 @@ s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x550F550F, xAAF0AAF0, xA5F5A5F5, x96C696C6, x00FFFF00, x963969C6;
 	vtype x2E3C2E3C, xB73121F7, x1501DF0F, x00558A5F, x2E69A463;
@@ -813,7 +813,7 @@ s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x550F550F, xAAF0AAF0, xA5F5A5F5, x96C696C6, x00FFFF00, x963969C6;
 	vtype x2E3C2E3C, xB73121F7, x1501DF0F, x00558A5F, x2E69A463;
@@ -879,7 +879,7 @@ s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x550F550F, xAAF0AAF0, xA5F5A5F5, x96C696C6, x00FFFF00, x963969C6;
 	vtype x2E3C2E3C, xB73121F7, x1501DF0F, x00558A5F, x2E69A463;
@@ -947,7 +947,7 @@ s5(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s6(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x555500FF, x666633CC, x606F30CF, x353A659A, x353A9A65, xCAC5659A;
 	vtype x353A6565, x0A3F0A6F, x6C5939A3, x5963A3C6;
@@ -1012,7 +1012,7 @@ s6(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s6(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x555500FF, x666633CC, x606F30CF, x353A659A, x353A9A65, xCAC5659A;
 	vtype x353A6565, x0A3F0A6F, x6C5939A3, x5963A3C6;
@@ -1077,7 +1077,7 @@ s6(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s6(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x555500FF, x666633CC, x606F30CF, x353A659A, x353A9A65, xCAC5659A;
 	vtype x353A6565, x0A3F0A6F, x6C5939A3, x5963A3C6;
@@ -1142,7 +1142,7 @@ s6(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s6(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x555500FF, x666633CC, x606F30CF, x353A659A, x353A9A65, xCAC5659A;
 	vtype x553A5565, x0A3F0A6F, x6C5939A3, x5963A3C6;
@@ -1208,7 +1208,7 @@ s6(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s7(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x44447777, x4B4B7878, x22772277, x0505F5F5, x220522F5, x694E5A8D;
 	vtype x00FFFF00, x66666666, x32353235, x26253636, x26DAC936;
@@ -1272,7 +1272,7 @@ s7(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s7(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x44447777, x4B4B7878, x22772277, x0505F5F5, x220522F5, x694E5A8D;
 	vtype x00FFFF00, x66666666, x32353235, x26253636, x26DAC936;
@@ -1338,7 +1338,7 @@ s7(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s8(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x0505F5F5, x05FAF50A, x0F0F00FF, x22227777, x07DA807F, x34E9B34C;
 	vtype x00FFF00F, x0033FCCF, x5565B15C, x0C0C3F3F, x59698E63;
@@ -1399,7 +1399,7 @@ s8(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
 inline  void
 s8(vtype a1, vtype a2, vtype a3, vtype a4, vtype a5, vtype a6,
    __private  vtype * out,
-   vtype c1, vtype c2 ,vtype c3 , vtype c4)
+   unsigned int c1, unsigned int c2, unsigned int c3, unsigned int c4)
 {
 	vtype x0505F5F5, x05FAF50A, x0F0F00FF, x22227777, x07DA807F, x34E9B34C;
 	vtype x00FFF00F, x0033FCCF, x5565B15C, x0C0C3F3F, x59698E63;
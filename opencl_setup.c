@@ -29,8 +29,10 @@ static HMODULE ocl = NULL; /* TODO: release on program exit. */
 static void *ocl = NULL;   /* TODO: release on program exit. */
 #endif
 
+#include "cpu_rt_functions.h"
 #include "misc.h"
 #include "opencl_setup.h"
+#include "shared.h"
 
 
 /* Toggled when the OpenCL library is loaded and initialized. */
@@ -58,10 +60,12 @@ cl_int (*rc_clGetProgramBuildInfo)(cl_program, cl_device_id, cl_program_build_in
 cl_int (*rc_clReleaseCommandQueue)(cl_command_queue) = NULL;
 cl_int (*rc_clReleaseContext)(cl_context) = NULL;
 cl_int (*rc_clReleaseDevice)(cl_device_id) = NULL;
+cl_int (*rc_clReleaseEvent)(cl_event) = NULL;
 cl_int (*rc_clReleaseKernel)(cl_kernel) = NULL;
 cl_int (*rc_clReleaseMemObject)(cl_mem) = NULL;
 cl_int (*rc_clReleaseProgram)(cl_program) = NULL;
 cl_int (*rc_clSetKernelArg)(cl_kernel, cl_uint, size_t, const void *) = NULL;
+cl_int (*rc_clWaitForEvents)(cl_uint, const cl_event *) = NULL;
 
 
 #ifdef _WIN32
@@ -201,10 +205,12 @@ void get_platforms_and_devices(int disable_platform, cl_uint platforms_buffer_si
     LOADFUNC(ocl, clReleaseCommandQueue);
     LOADFUNC(ocl, clReleaseContext);
     LOADFUNC(ocl, clReleaseDevice);
+    LOADFUNC(ocl, clReleaseEvent);
     LOADFUNC(ocl, clReleaseKernel);
     LOADFUNC(ocl, clReleaseMemObject);
     LOADFUNC(ocl, clReleaseProgram);
     LOADFUNC(ocl, clSetKernelArg);
+    LOADFUNC(ocl, clWaitForEvents);
 
     opencl_initialized = 1;
   }
@@ -294,13 +300,50 @@ void get_platforms_and_devices(int disable_platform, cl_uint platforms_buffer_si
 }
 
 
-/* Loads a kernel onto a device. */
-void load_kernel(cl_context context, cl_uint num_devices, const cl_device_id *devices, const char *source_filename, const char *kernel_name, cl_program *program, cl_kernel *kernel, unsigned int hash_type) {
+/* Fills in the build options that compile a table's parameters into the crackalack,
+ * precompute, and false_alarm_check kernels as constants.  The standard NTLM8 and NTLM9
+ * tables select the hand-optimized reduction and hashing functions; other tables get
+ * their charset, plaintext lengths, plaintext space, and chain length.  The reduction
+ * offset is left as a kernel argument, since it is the only thing that differs between
+ * the tables of a set. */
+void get_table_build_options(char *build_options, size_t build_options_size, unsigned int hash_type, char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned int reduction_offset, unsigned int chain_len) {
+  uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
+  uint64_t plaintext_space_total = 0;
+  unsigned int i = 0, charset_len = strlen(charset);
+  int n = 0;
+
+
+  if (is_ntlm8(hash_type, charset, plaintext_len_min, plaintext_len_max, reduction_offset, chain_len))
+    n = snprintf(build_options, build_options_size, "-DNTLM_FIXED_LEN=8");
+  else if (is_ntlm9(hash_type, charset, plaintext_len_min, plaintext_len_max, reduction_offset, chain_len))
+    n = snprintf(build_options, build_options_size, "-DNTLM_FIXED_LEN=9");
+  else {
+    plaintext_space_total = fill_plaintext_space_table(charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index);
+    n = snprintf(build_options, build_options_size, "-DTABLE_CHARSET_LEN=%uU -DTABLE_PLAINTEXT_LEN_MIN=%uU -DTABLE_PLAINTEXT_LEN_MAX=%uU -DTABLE_PLAINTEXT_SPACE_TOTAL=%"PRIu64"UL -DTABLE_CHAIN_LEN=%uU -DTABLE_CHARSET={", charset_len, plaintext_len_min, plaintext_len_max, plaintext_space_total, chain_len);
+
+    /* The charset is given as a list of character codes so that no quoting is needed. */
+    for (i = 0; (i < charset_len) && (n > 0) && (n < build_options_size); i++)
+      n += snprintf(build_options + n, build_options_size - n, "%s%u", (i == 0) ? "" : ",", (unsigned char)charset[i]);
+
+    if ((n > 0) && (n < build_options_size))
+      n += snprintf(build_options + n, build_options_size - n, "}");
+  }
+
+  if ((n < 0) || (n >= build_options_size)) {
+    fprintf(stderr, "Error: table build options too long!\n");
+    exit(-1);
+  }
+}
+
+
+/* Loads a kernel onto a device.  If table_build_options is not NULL, it is appended to
+ * the build options (see get_table_build_options()). */
+void load_kernel(cl_context context, cl_uint num_devices, const cl_device_id *devices, const char *source_filename, const char *kernel_name, cl_program *program, cl_kernel *kernel, unsigned int hash_type, const char *table_build_options) {
   FILE *f = NULL;
   char *source = NULL;
   int file_size = 0, bytes_read = 0, n = 0;
   int err = 0;
-  char build_options[512] = {0};
+  char build_options[2048] = {0};
   char device_vendor[128] = {0};
   char path[256] = {0};
 
@@ -350,6 +393,11 @@ void load_kernel(cl_context context, cl_uint num_devices, const cl_device_id *de
   strncat(build_options, " -DUSE_DES_BITSLICE=1", sizeof(build_options) - 1);
 #endif
 
+  if (table_build_options != NULL) {
+    strncat(build_options, " ", sizeof(build_options) - strlen(build_options) - 1);
+    strncat(build_options, table_build_options, sizeof(build_options) - strlen(build_options) - 1);
+  }
+
   get_device_str(devices[0], CL_DEVICE_VENDOR, device_vendor, sizeof(device_vendor) - 1);
 
 #ifdef _WIN32
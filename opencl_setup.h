@@ -43,10 +43,12 @@ extern cl_int (*rc_clGetProgramBuildInfo)(cl_program, cl_device_id, cl_program_b
 extern cl_int (*rc_clReleaseCommandQueue)(cl_command_queue);
 extern cl_int (*rc_clReleaseContext)(cl_context);
 extern cl_int (*rc_clReleaseDevice)(cl_device_id);
+extern cl_int (*rc_clReleaseEvent)(cl_event);
 extern cl_int (*rc_clReleaseKernel)(cl_kernel);
 extern cl_int (*rc_clReleaseMemObject)(cl_mem);
 extern cl_int (*rc_clReleaseProgram)(cl_program);
 extern cl_int (*rc_clSetKernelArg)(cl_kernel, cl_uint, size_t, const void *);
+extern cl_int (*rc_clWaitForEvents)(cl_uint, const cl_event *);
 
 
 #define CLMAKETESTVARS() \
@@ -90,6 +92,27 @@ extern cl_int (*rc_clSetKernelArg)(cl_kernel, cl_uint, size_t, const void *);
 #define CLREADBUFFER(_buffer, _len, _ptr) \
   { err = rc_clEnqueueReadBuffer(queue, _buffer, CL_TRUE, 0, _len, _ptr, 0, NULL, NULL); if (err < 0) { fprintf(stderr, "clEnqueueReadBuffer failed: %d\n", err); exit(-1); } }
 
+/* Creates a buffer without writing to it or setting it as a kernel argument. */
+#define CLCREATEBUFFER(_buffer, _flags, _len) \
+  { _buffer = rc_clCreateBuffer(context, _flags, _len, NULL, &err); if (err < 0) { fprintf(stderr, "Error while creating buffer for \"%s\". Error code: %d\n", #_buffer, err); exit(-1); } }
+
+#define CLSETARG(_arg_index, _buffer) \
+  { err = rc_clSetKernelArg(kernel, _arg_index, sizeof(cl_mem), &_buffer); if (err < 0) { fprintf(stderr, "Error setting kernel argument for %s at index %u.\n", #_buffer, _arg_index); exit(-1); } }
+
+/* Non-blocking writes and reads.  The host memory must stay untouched until the
+ * queue is finished with it (for reads, until the event is waited on). */
+#define CLWRITEBUFFERASYNC(_buffer, _len, _ptr) \
+  { err = rc_clEnqueueWriteBuffer(queue, _buffer, CL_FALSE, 0, _len, _ptr, 0, NULL, NULL); if (err < 0) { fprintf(stderr, "clEnqueueWriteBuffer failed: %d\n", err); exit(-1); } }
+
+#define CLREADBUFFERASYNC(_buffer, _len, _ptr, _event_ptr) \
+  { err = rc_clEnqueueReadBuffer(queue, _buffer, CL_FALSE, 0, _len, _ptr, 0, NULL, _event_ptr); if (err < 0) { fprintf(stderr, "clEnqueueReadBuffer failed: %d\n", err); exit(-1); } }
+
+#define CLWAITEVENT(_event) \
+  { err = rc_clWaitForEvents(1, &(_event)); if (err < 0) { fprintf(stderr, "clWaitForEvents failed: %d\n", err); exit(-1); } CLRELEASEEVENT(_event); }
+
+#define CLRELEASEEVENT(_event) \
+  if (_event != NULL) { err = rc_clReleaseEvent(_event); if (err < 0) { fprintf(stderr, "clReleaseEvent failed: %d\n", err); exit(-1); } _event = NULL; }
+
 #define CLFREEBUFFER(_buffer) \
   if (_buffer != NULL) { rc_clReleaseMemObject(_buffer); _buffer = NULL; }
 
@@ -117,7 +140,8 @@ void get_device_str(cl_device_id device, cl_device_info param, char *buf, int bu
 void get_device_uint(cl_device_id device, cl_device_info param, cl_uint *u);
 void get_device_ulong(cl_device_id device, cl_device_info param, cl_ulong *ul);
 void get_platform_str(cl_platform_id device, cl_platform_info param, char *buf, size_t buf_len);
-void load_kernel(cl_context context, cl_uint num_devices, const cl_device_id *devices, const char *path, const char *kernel_name, cl_program *program, cl_kernel *kernel, unsigned int hash_type);
+void get_table_build_options(char *build_options, size_t build_options_size, unsigned int hash_type, char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned int reduction_offset, unsigned int chain_len);
+void load_kernel(cl_context context, cl_uint num_devices, const cl_device_id *devices, const char *path, const char *kernel_name, cl_program *program, cl_kernel *kernel, unsigned int hash_type, const char *table_build_options);
 void print_device_info(cl_device_id *devices, cl_uint num_devices);
 void print_platform_info(cl_platform_id *platforms, cl_uint num_platforms);
 
@@ -0,0 +1,627 @@
+/*
+ * Rainbow Crackalack: rt_search.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu_features.h"
+#include "misc.h"
+#include "rt_search.h"
+
+#ifdef CPU_SIMD_SUPPORTED
+#include <immintrin.h>
+#endif
+
+
+/* Marks a search in a batch as finished. */
+#define SEARCH_DONE UINT_MAX
+
+
+/* Allocates an array of uint64_t's aligned to a cache line, so that each tree node
+ * occupies exactly one.  Terminates the program on failure. */
+static uint64_t *alloc_cache_aligned(unsigned int num_elements) {
+  void *ret = NULL;
+
+
+#ifdef _WIN32
+  ret = _aligned_malloc(num_elements * sizeof(uint64_t), 64);
+#else
+  if (posix_memalign(&ret, 64, num_elements * sizeof(uint64_t)) != 0)
+    ret = NULL;
+#endif
+
+  if (ret == NULL) {
+    fprintf(stderr, "Failed to allocate %"PRIu64" bytes for table search structure.\n", (uint64_t)num_elements * sizeof(uint64_t));
+    exit(-1);
+  }
+  return (uint64_t *)ret;
+}
+
+
+static void free_cache_aligned(uint64_t *ptr) {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+
+/* Returns the number of keys in the node that are less than the search key. */
+static inline unsigned int node_count_less(const uint64_t *node, uint64_t key) {
+  unsigned int i = 0, ret = 0;
+
+
+  for (i = 0; i < RT_SEARCH_NODE_KEYS; i++)
+    ret += (node[i] < key);
+
+  return ret;
+}
+
+
+#ifdef CPU_SIMD_SUPPORTED
+/* Same as node_count_less(), but compares the search key against 4 keys at a time.
+ * AVX2 only has a signed 64-bit comparison, so the sign bits of both sides are flipped
+ * first, which gives the same result as an unsigned one. */
+__attribute__((target("avx2,popcnt")))
+static inline unsigned int node_count_less_avx2(const uint64_t *node, uint64_t key) {
+  __m256i sign = _mm256_set1_epi64x(INT64_MIN), search_key = _mm256_xor_si256(_mm256_set1_epi64x(key), sign);
+  __m256i keys_lo = _mm256_xor_si256(_mm256_load_si256((const __m256i *)node), sign);
+  __m256i keys_hi = _mm256_xor_si256(_mm256_load_si256((const __m256i *)(node + 4)), sign);
+  unsigned int less_lo = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(search_key, keys_lo)));
+  unsigned int less_hi = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(search_key, keys_hi)));
+
+
+  return __builtin_popcount(less_lo | (less_hi << 4));
+}
+
+
+/* Same as node_count_less(), but compares the search key against all 8 keys at once. */
+__attribute__((target("avx512f,popcnt")))
+static inline unsigned int node_count_less_avx512(const uint64_t *node, uint64_t key) {
+  __mmask8 less = _mm512_cmplt_epu64_mask(_mm512_load_si512(node), _mm512_set1_epi64(key));
+
+
+  return __builtin_popcount(less);
+}
+#endif
+
+
+/* Rounds n up to a whole number of nodes. */
+static inline unsigned int round_up_to_node(unsigned int n) {
+  return ((n + RT_SEARCH_NODE_KEYS - 1) / RT_SEARCH_NODE_KEYS) * RT_SEARCH_NODE_KEYS;
+}
+
+
+/* Builds the prefix directory over the end indices.  There are about as many buckets
+ * as leaf nodes (up to 2^RT_SEARCH_MAX_BUCKET_BITS), and the shift is chosen so that
+ * the largest end index falls in the last one. */
+static void build_bucket_directory(rt_search_table *rst) {
+  unsigned int bucket_bits = 0, bucket = 0, i = 0;
+  uint64_t max_end_index = 0;
+
+
+  /* Tables that fit in a few nodes are quick enough to search from the root. */
+  while (((RT_SEARCH_NODE_KEYS << bucket_bits) < rst->num_chains) && (bucket_bits < RT_SEARCH_MAX_BUCKET_BITS))
+    bucket_bits++;
+
+  if (bucket_bits == 0)
+    return;
+
+  rst->num_buckets = 1 << bucket_bits;
+  rst->buckets = calloc(rst->num_buckets + 1, sizeof(uint32_t));
+  if (rst->buckets == NULL) {
+    fprintf(stderr, "Failed to allocate bucket directory.\n");
+    exit(-1);
+  }
+
+  max_end_index = rst->end_indices[rst->num_chains - 1];
+  while ((max_end_index >> rst->bucket_shift) >= rst->num_buckets)
+    rst->bucket_shift++;
+
+  /* Each bucket starts at the first end index whose top bits are not less than it. */
+  for (i = 0; i < rst->num_chains; i++) {
+    while (bucket <= (rst->end_indices[i] >> rst->bucket_shift))
+      rst->buckets[bucket++] = i;
+  }
+  while (bucket <= rst->num_buckets)
+    rst->buckets[bucket++] = rst->num_chains;
+}
+
+
+/* Prepares a sorted rainbow table for searching.  The table is in its file format
+ * (interleaved start and end indices); ownership of it is taken, and its memory is
+ * re-used for the start indices.  An empty table (which may be NULL) is valid, and
+ * searches of it find nothing. */
+void rt_search_table_init(rt_search_table *rst, uint64_t *rainbow_table, unsigned int num_chains) {
+  unsigned int level_sizes[RT_SEARCH_MAX_LEVELS] = {0};
+  unsigned int num_padded = round_up_to_node(num_chains), level_size = 0, child_size = 0, tree_size = 0, i = 0, level = 0;
+  uint64_t *child_keys = NULL, *keys = NULL;
+
+
+  memset(rst, 0, sizeof(rt_search_table));
+  rst->num_chains = num_chains;
+
+  /* An empty table still gets one node of end indices (all padding), so that it can
+   * be searched like any other. */
+  if (num_padded == 0)
+    num_padded = RT_SEARCH_NODE_KEYS;
+
+  /* Split the chains into the two arrays.  The start indices are compacted in place:
+   * chain i is never stored past where chain i is read from. */
+  rst->end_indices = alloc_cache_aligned(num_padded);
+  for (i = 0; i < num_chains; i++) {
+    rst->end_indices[i] = rainbow_table[(i * 2) + 1];
+    rainbow_table[i] = rainbow_table[i * 2];
+  }
+  for (; i < num_padded; i++)
+    rst->end_indices[i] = UINT64_MAX;
+
+  if (num_chains == 0) {
+    FREE(rainbow_table);
+  } else {
+    rst->start_indices = realloc(rainbow_table, num_chains * sizeof(uint64_t));
+    if (rst->start_indices == NULL) {
+      fprintf(stderr, "Failed to shrink rainbow table.\n");
+      exit(-1);
+    }
+  }
+
+  /* Each level has one key per node of the level below it, until a level fits in a
+   * single node (the root).  Tables that fit in one node need no tree at all. */
+  level_size = num_padded;
+  while (level_size > RT_SEARCH_NODE_KEYS) {
+    if (rst->num_levels == RT_SEARCH_MAX_LEVELS) {
+      fprintf(stderr, "Error: table has too many chains to search: %u\n", num_chains);
+      exit(-1);
+    }
+
+    level_size = round_up_to_node(level_size / RT_SEARCH_NODE_KEYS);
+    level_sizes[rst->num_levels] = level_size;
+    rst->num_levels++;
+  }
+
+  /* The levels were counted from the bottom up, but are stored from the root down. */
+  for (level = 0; level < rst->num_levels; level++) {
+    rst->level_offsets[level] = tree_size;
+    tree_size += level_sizes[rst->num_levels - level - 1];
+  }
+
+  build_bucket_directory(rst);
+  if (tree_size == 0)
+    return;
+
+  rst->tree = alloc_cache_aligned(tree_size);
+
+  /* Each key is the first key of a child node.  Keys past the end of the level below
+   * are padding, and are never descended into. */
+  child_keys = rst->end_indices;
+  child_size = num_padded;
+  for (level = 0; level < rst->num_levels; level++) {
+    keys = rst->tree + rst->level_offsets[rst->num_levels - level - 1];
+    for (i = 0; i < level_sizes[level]; i++)
+      keys[i] = ((i * RT_SEARCH_NODE_KEYS) < child_size) ? child_keys[i * RT_SEARCH_NODE_KEYS] : UINT64_MAX;
+
+    child_keys = keys;
+    child_size = level_sizes[level];
+  }
+}
+
+
+/* Finds where the search for an end index starts.  The end index's bucket gives the
+ * range that its position is in: everything before the bucket is less than it, and
+ * everything after is greater.  The descent then starts from the lowest node that
+ * covers the whole range.  Returns 1 if the bucket alone determines the position (in
+ * which case it is stored in pos). */
+static inline unsigned int search_start(const rt_search_table *rst, uint64_t end_index, unsigned int *level, unsigned int *node, unsigned int *pos) {
+  unsigned int low = 0, high = 0, node_levels = 1;
+  uint64_t bucket = 0;
+
+
+  *level = 0;
+  *node = 0;
+  if (rst->num_buckets == 0)
+    return 0;
+
+  bucket = end_index >> rst->bucket_shift;
+  if (bucket >= rst->num_buckets) {
+    *pos = rst->num_chains;
+    return 1;
+  }
+
+  low = rst->buckets[bucket];
+  high = rst->buckets[bucket + 1];
+  if (low == high) {
+    *pos = low;
+    return 1;
+  }
+
+  /* A node of end indices covers 2^RT_SEARCH_NODE_BITS positions, a node on the level
+   * above it covers 2^(2 * RT_SEARCH_NODE_BITS), and so on. */
+  while ((node_levels <= rst->num_levels) && ((((uint64_t)low ^ (high - 1)) >> (node_levels * RT_SEARCH_NODE_BITS)) != 0))
+    node_levels++;
+
+  *level = rst->num_levels + 1 - node_levels;
+  *node = (uint64_t)low >> (node_levels * RT_SEARCH_NODE_BITS);
+  return 0;
+}
+
+
+/* Returns a pointer to the specified node.  The level after the last tree level is the
+ * end indices themselves. */
+static inline const uint64_t *node_keys(const rt_search_table *rst, unsigned int level, unsigned int node) {
+  if (level < rst->num_levels)
+    return rst->tree + rst->level_offsets[level] + (node * RT_SEARCH_NODE_KEYS);
+  else
+    return rst->end_indices + (node * RT_SEARCH_NODE_KEYS);
+}
+
+
+/* Returns the child of a tree node to descend into, given the number of the node's keys
+ * that are less than the end index: the last child whose first key is less than it.
+ * The first match (if any) is either in that child, or is the first key of the next
+ * one. */
+static inline unsigned int child_node(unsigned int node, unsigned int num_less) {
+  return (node * RT_SEARCH_NODE_KEYS) + ((num_less > 0) ? (num_less - 1) : 0);
+}
+
+
+/* Returns the position of the end index, given the node of end indices it was found in
+ * and the number of that node's keys that are less than it. */
+static inline unsigned int leaf_position(const rt_search_table *rst, unsigned int node, unsigned int num_less) {
+  unsigned int pos = (node * RT_SEARCH_NODE_KEYS) + num_less;
+
+  return (pos < rst->num_chains) ? pos : rst->num_chains;
+}
+
+
+/* The body of the single search function for each SIMD level.  COUNT_LESS is the
+ * node_count_less() variant of that level. */
+#define LOWER_BOUND_BODY \
+  unsigned int node = 0, level = 0, pos = 0; \
+  \
+  \
+  if (search_start(rst, end_index, &level, &node, &pos)) \
+    return pos; \
+  \
+  for (; level < rst->num_levels; level++) \
+    node = child_node(node, COUNT_LESS(node_keys(rst, level, node), end_index)); \
+  \
+  return leaf_position(rst, node, COUNT_LESS(node_keys(rst, level, node), end_index));
+
+
+/* The body of the batched search function for each SIMD level.  Each level of a search
+ * depends on the one before it, so one search at a time leaves the CPU waiting on one
+ * cache miss after another.  Instead, RT_SEARCH_BATCH_SIZE searches are advanced
+ * together, and the next node of each is prefetched while the others are worked on. */
+#define LOWER_BOUND_MANY_BODY \
+  unsigned int levels[RT_SEARCH_BATCH_SIZE], nodes[RT_SEARCH_BATCH_SIZE]; \
+  unsigned int i = 0, j = 0, batch_size = 0, num_active = 0, num_less = 0; \
+  uint64_t bucket = 0; \
+  \
+  \
+  for (i = 0; i < num_end_indices; i += batch_size) { \
+    batch_size = num_end_indices - i; \
+    if (batch_size > RT_SEARCH_BATCH_SIZE) \
+      batch_size = RT_SEARCH_BATCH_SIZE; \
+    \
+    if (rst->num_buckets > 0) { \
+      for (j = 0; j < batch_size; j++) { \
+	bucket = end_indices[i + j] >> rst->bucket_shift; \
+	if (bucket < rst->num_buckets) \
+	  __builtin_prefetch(rst->buckets + bucket); \
+      } \
+    } \
+    \
+    num_active = 0; \
+    for (j = 0; j < batch_size; j++) { \
+      if (search_start(rst, end_indices[i + j], &(levels[j]), &(nodes[j]), &(positions[i + j]))) \
+	levels[j] = SEARCH_DONE; \
+      else { \
+	__builtin_prefetch(node_keys(rst, levels[j], nodes[j])); \
+	num_active++; \
+      } \
+    } \
+    \
+    /* Searches that started lower in the tree finish sooner. */ \
+    while (num_active > 0) { \
+      for (j = 0; j < batch_size; j++) { \
+	if (levels[j] == SEARCH_DONE) \
+	  continue; \
+	\
+	num_less = COUNT_LESS(node_keys(rst, levels[j], nodes[j]), end_indices[i + j]); \
+	if (levels[j] < rst->num_levels) { \
+	  nodes[j] = child_node(nodes[j], num_less); \
+	  levels[j]++; \
+	  __builtin_prefetch(node_keys(rst, levels[j], nodes[j])); \
+	} else { \
+	  positions[i + j] = leaf_position(rst, nodes[j], num_less); \
+	  levels[j] = SEARCH_DONE; \
+	  num_active--; \
+	} \
+      } \
+    } \
+  }
+
+
+#define COUNT_LESS node_count_less
+static unsigned int lower_bound_scalar(const rt_search_table *rst, uint64_t end_index) {
+  LOWER_BOUND_BODY
+}
+
+static void lower_bound_many_scalar(const rt_search_table *rst, const uint64_t *end_indices, unsigned int num_end_indices, unsigned int *positions) {
+  LOWER_BOUND_MANY_BODY
+}
+#undef COUNT_LESS
+
+
+#ifdef CPU_SIMD_SUPPORTED
+#define COUNT_LESS node_count_less_avx2
+__attribute__((target("avx2,popcnt")))
+static unsigned int lower_bound_avx2(const rt_search_table *rst, uint64_t end_index) {
+  LOWER_BOUND_BODY
+}
+
+__attribute__((target("avx2,popcnt")))
+static void lower_bound_many_avx2(const rt_search_table *rst, const uint64_t *end_indices, unsigned int num_end_indices, unsigned int *positions) {
+  LOWER_BOUND_MANY_BODY
+}
+#undef COUNT_LESS
+
+#define COUNT_LESS node_count_less_avx512
+__attribute__((target("avx512f,popcnt")))
+static unsigned int lower_bound_avx512(const rt_search_table *rst, uint64_t end_index) {
+  LOWER_BOUND_BODY
+}
+
+__attribute__((target("avx512f,popcnt")))
+static void lower_bound_many_avx512(const rt_search_table *rst, const uint64_t *end_indices, unsigned int num_end_indices, unsigned int *positions) {
+  LOWER_BOUND_MANY_BODY
+}
+#undef COUNT_LESS
+#endif /* CPU_SIMD_SUPPORTED */
+
+
+/* Returns the position of the first end index that is not less than the specified
+ * one (or the number of chains, if there is none). */
+unsigned int rt_search_table_lower_bound(const rt_search_table *rst, uint64_t end_index) {
+#ifdef CPU_SIMD_SUPPORTED
+  unsigned int simd_level = get_simd_level();
+
+
+  if (simd_level == SIMD_AVX512)
+    return lower_bound_avx512(rst, end_index);
+  else if (simd_level == SIMD_AVX2)
+    return lower_bound_avx2(rst, end_index);
+#endif
+
+  return lower_bound_scalar(rst, end_index);
+}
+
+
+/* Same as rt_search_table_lower_bound(), but for many end indices at once; the position
+ * of end_indices[i] is stored in positions[i]. */
+void rt_search_table_lower_bound_many(const rt_search_table *rst, const uint64_t *end_indices, unsigned int num_end_indices, unsigned int *positions) {
+#ifdef CPU_SIMD_SUPPORTED
+  unsigned int simd_level = get_simd_level();
+
+
+  if (simd_level == SIMD_AVX512) {
+    lower_bound_many_avx512(rst, end_indices, num_end_indices, positions);
+    return;
+  } else if (simd_level == SIMD_AVX2) {
+    lower_bound_many_avx2(rst, end_indices, num_end_indices, positions);
+    return;
+  }
+#endif
+
+  lower_bound_many_scalar(rst, end_indices, num_end_indices, positions);
+}
+
+
+/* Searches the table for the specified end index.  If found, its start index is
+ * stored in start and 1 is returned.  When several chains have the same end index,
+ * the first one is returned. */
+unsigned int rt_search_table_find(const rt_search_table *rst, uint64_t end_index, uint64_t *start) {
+  unsigned int pos = rt_search_table_lower_bound(rst, end_index);
+
+
+  if ((pos < rst->num_chains) && (rst->end_indices[pos] == end_index)) {
+    *start = rst->start_indices[pos];
+    return 1;
+  }
+  return 0;
+}
+
+
+/* Searches the table for many end indices, all belonging to one hash: end_indices[i]
+ * is at position (first_position + i) of that hash's precomputed end indices.  The
+ * searches are done in batches, so that their memory accesses overlap.  hit_func is
+ * called for each one that is found. */
+void rt_search_table_find_many(const rt_search_table *rst, const uint64_t *end_indices, unsigned int num_end_indices, unsigned int hash_number, unsigned int first_position, rt_search_hit_func hit_func, void *ctx) {
+  unsigned int positions[RT_SEARCH_BATCH_SIZE];
+  unsigned int i = 0, j = 0, n = 0, pos = 0;
+
+
+  for (i = 0; i < num_end_indices; i += n) {
+    n = num_end_indices - i;
+    if (n > RT_SEARCH_BATCH_SIZE)
+      n = RT_SEARCH_BATCH_SIZE;
+
+    rt_search_table_lower_bound_many(rst, &(end_indices[i]), n, positions);
+    for (j = 0; j < n; j++) {
+      pos = positions[j];
+      if ((pos < rst->num_chains) && (rst->end_indices[pos] == end_indices[i + j]))
+	hit_func(ctx, hash_number, first_position + i + j, rst->start_indices[pos]);
+    }
+  }
+}
+
+
+/* Frees the table and its search structure. */
+void rt_search_table_free(rt_search_table *rst) {
+  FREE(rst->start_indices);
+  if (rst->end_indices != NULL) {
+    free_cache_aligned(rst->end_indices);
+    rst->end_indices = NULL;
+  }
+  if (rst->tree != NULL) {
+    free_cache_aligned(rst->tree);
+    rst->tree = NULL;
+  }
+  FREE(rst->buckets);
+  rst->num_chains = 0;
+  rst->num_levels = 0;
+  rst->num_buckets = 0;
+  rst->bucket_shift = 0;
+}
+
+
+/* Sorts tagged end indices by end index, then by hash and position (for qsort()). */
+int rt_compare_tagged_end_indices(const void *a, const void *b) {
+  const rt_tagged_end_index *ta = (const rt_tagged_end_index *)a, *tb = (const rt_tagged_end_index *)b;
+
+  if (ta->end_index != tb->end_index)
+    return (ta->end_index < tb->end_index) ? -1 : 1;
+  else if (ta->hash_number != tb->hash_number)
+    return (ta->hash_number < tb->hash_number) ? -1 : 1;
+  else if (ta->position != tb->position)
+    return (ta->position < tb->position) ? -1 : 1;
+  return 0;
+}
+
+
+/* Joins positions [first, last) of the sorted tagged end indices with the table.
+ * Since both are sorted, the table is read forward only, starting from the first
+ * one's position in it.  Hashes whose entry in skip_hashes is set (if it isn't NULL)
+ * are skipped; hit_func is called for every other match. */
+void rt_search_table_merge_join(const rt_search_table *rst, const rt_tagged_end_index *sorted_end_indices, unsigned int first, unsigned int last, const unsigned char *skip_hashes, rt_search_hit_func hit_func, void *ctx) {
+  const rt_tagged_end_index *query = NULL;
+  unsigned int i = 0, t = 0;
+
+
+  if (first >= last)
+    return;
+
+  t = rt_search_table_lower_bound(rst, sorted_end_indices[first].end_index);
+  for (i = first; (i < last) && (t < rst->num_chains); i++) {
+    query = &(sorted_end_indices[i]);
+    while ((t < rst->num_chains) && (rst->end_indices[t] < query->end_index))
+      t++;
+
+    /* As with the tree search, only the first chain with a matching end index is
+     * used.  The position isn't advanced past it, since the next query may be a
+     * duplicate. */
+    if ((t < rst->num_chains) && (rst->end_indices[t] == query->end_index)) {
+      if ((skip_hashes == NULL) || !skip_hashes[query->hash_number])
+	hit_func(ctx, query->hash_number, query->position, rst->start_indices[t]);
+    }
+  }
+}
+
+
+/* Returns the first slot to probe for an end index in an end index set.  End indices
+ * are close to uniformly distributed, but multiplying by a large odd constant keeps
+ * runs of nearby ones from clustering together. */
+#define END_INDEX_SET_SLOT(_set, _end_index) (((_end_index) * 0x9E3779B97F4A7C15ULL) >> (64 - (_set)->bits))
+
+
+/* Creates an empty end index set for the specified number of entries.  The set has at
+ * least 4/3 as many slots as entries, so that probe sequences stay short.  Returns 1
+ * on success, or 0 if there wasn't enough memory. */
+unsigned int rt_end_index_set_init(rt_end_index_set *set, unsigned int num_entries) {
+  set->bits = 4;
+  while ((1ULL << set->bits) < ((uint64_t)num_entries + (num_entries / 3)))
+    set->bits++;
+
+  set->slots = malloc((1ULL << set->bits) * sizeof(rt_tagged_end_index));
+  if (set->slots == NULL)
+    return 0;
+
+  memset(set->slots, 0xff, (1ULL << set->bits) * sizeof(rt_tagged_end_index));
+  set->mask = (1ULL << set->bits) - 1;
+  return 1;
+}
+
+
+/* Adds a tagged end index to an end index set.  The set must have been created with
+ * room for it. */
+void rt_end_index_set_add(rt_end_index_set *set, uint64_t end_index, unsigned int hash_number, unsigned int position) {
+  uint64_t slot = 0;
+
+
+  for (slot = END_INDEX_SET_SLOT(set, end_index); set->slots[slot].end_index != UINT64_MAX; slot = (slot + 1) & set->mask)
+    ;
+
+  set->slots[slot].end_index = end_index;
+  set->slots[slot].hash_number = hash_number;
+  set->slots[slot].position = position;
+}
+
+
+/* Frees an end index set. */
+void rt_end_index_set_free(rt_end_index_set *set) {
+  FREE(set->slots);
+  set->bits = 0;
+  set->mask = 0;
+}
+
+
+/* Joins chains [first_chain, last_chain) of the table with an end index set.  The
+ * probes for a batch of chains are prefetched together, so that their cache misses
+ * overlap.  Hashes whose entry in skip_hashes is set (if it isn't NULL) are skipped;
+ * hit_func is called for every other match. */
+void rt_search_table_hash_join(const rt_search_table *rst, const rt_end_index_set *set, unsigned int first_chain, unsigned int last_chain, const unsigned char *skip_hashes, rt_search_hit_func hit_func, void *ctx) {
+  const rt_tagged_end_index *entry = NULL;
+  uint64_t slots[RT_SEARCH_BATCH_SIZE], slot = 0, end_index = 0;
+  unsigned int i = 0, j = 0, n = 0, t = 0;
+
+
+  for (i = first_chain; i < last_chain; i += n) {
+    n = last_chain - i;
+    if (n > RT_SEARCH_BATCH_SIZE)
+      n = RT_SEARCH_BATCH_SIZE;
+
+    for (j = 0; j < n; j++) {
+      slots[j] = END_INDEX_SET_SLOT(set, rst->end_indices[i + j]);
+      __builtin_prefetch(&(set->slots[slots[j]]));
+    }
+
+    for (j = 0; j < n; j++) {
+      t = i + j;
+      end_index = rst->end_indices[t];
+
+      /* As with the other search methods, only the first chain with a given end
+       * index is used. */
+      if ((t > 0) && (rst->end_indices[t - 1] == end_index))
+	continue;
+
+      /* Every tagged end index equal to this one is a match. */
+      for (slot = slots[j]; set->slots[slot].end_index != UINT64_MAX; slot = (slot + 1) & set->mask) {
+	entry = &(set->slots[slot]);
+	if ((entry->end_index == end_index) && ((skip_hashes == NULL) || !skip_hashes[entry->hash_number]))
+	  hit_func(ctx, entry->hash_number, entry->position, rst->start_indices[t]);
+      }
+    }
+  }
+}
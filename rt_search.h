@@ -0,0 +1,101 @@
+#ifndef _RT_SEARCH_H
+#define _RT_SEARCH_H
+
+#include <stdint.h>
+
+/* The number of keys in one node of the search tree (one 64-byte cache line). */
+#define RT_SEARCH_NODE_KEYS 8
+#define RT_SEARCH_NODE_BITS 3  /* log2(RT_SEARCH_NODE_KEYS) */
+
+/* The maximum number of tree levels above the end indices.  This is enough for 2^32
+ * chains. */
+#define RT_SEARCH_MAX_LEVELS 12
+
+/* The maximum number of buckets in the prefix directory.  At 4 bytes each, 2^16 of
+ * them take 256KB, which fits in the L2 cache of most CPUs. */
+#define RT_SEARCH_MAX_BUCKET_BITS 16
+
+/* The number of searches that rt_search_table_lower_bound_many() advances together. */
+#define RT_SEARCH_BATCH_SIZE 16
+
+
+/* A rainbow table prepared for searching its end indices.  The start and end indices
+ * are kept in parallel arrays, and the (sorted) end indices are indexed by a static
+ * B+-tree: each node is one cache line holding the first end index of each of its
+ * children.  Finding an end index then touches one cache line per level, instead of
+ * one per step of a binary search.
+ *
+ * Since end indices are close to uniformly distributed, a directory over their top
+ * bits narrows each search down to a small range of chains first.  The search then
+ * starts from the lowest tree node that covers that range, skipping the levels above
+ * it. */
+struct _rt_search_table {
+  uint64_t *start_indices;
+  uint64_t *end_indices;  /* Padded with UINT64_MAX up to a whole node. */
+  unsigned int num_chains;
+
+  uint64_t *tree;         /* All levels of the tree, with the root first. */
+  unsigned int num_levels;
+  unsigned int level_offsets[RT_SEARCH_MAX_LEVELS];
+
+  /* Bucket b holds the end indices whose top bits (end_index >> bucket_shift) are b;
+   * these are at positions buckets[b] up to buckets[b + 1]. */
+  uint32_t *buckets;      /* num_buckets + 1 entries. */
+  unsigned int num_buckets;
+  unsigned int bucket_shift;
+};
+typedef struct _rt_search_table rt_search_table;
+
+
+/* A precomputed end index, tagged with the number of the hash it belongs to and its
+ * position among that hash's precomputed end indices.  The joins take these, so that
+ * every hash's end indices can be searched for at once. */
+struct _rt_tagged_end_index {
+  uint64_t end_index;
+  uint32_t hash_number;
+  uint32_t position;
+};
+typedef struct _rt_tagged_end_index rt_tagged_end_index;
+
+
+/* Tagged end indices in an open-addressing hash set (with linear probing), for the
+ * hash join.  Empty slots have an end index of UINT64_MAX. */
+struct _rt_end_index_set {
+  rt_tagged_end_index *slots;
+  unsigned int bits;      /* log2 of the number of slots. */
+  uint64_t mask;
+};
+typedef struct _rt_end_index_set rt_end_index_set;
+
+
+/* Called by the search methods for each match: the hash number and position of the
+ * end index searched for, and the start index of the first chain in the table that
+ * has the same end index. */
+typedef void (*rt_search_hit_func)(void *ctx, unsigned int hash_number, unsigned int position, uint64_t start_index);
+
+
+void rt_search_table_init(rt_search_table *rst, uint64_t *rainbow_table, unsigned int num_chains);
+
+unsigned int rt_search_table_lower_bound(const rt_search_table *rst, uint64_t end_index);
+
+void rt_search_table_lower_bound_many(const rt_search_table *rst, const uint64_t *end_indices, unsigned int num_end_indices, unsigned int *positions);
+
+unsigned int rt_search_table_find(const rt_search_table *rst, uint64_t end_index, uint64_t *start);
+
+void rt_search_table_find_many(const rt_search_table *rst, const uint64_t *end_indices, unsigned int num_end_indices, unsigned int hash_number, unsigned int first_position, rt_search_hit_func hit_func, void *ctx);
+
+void rt_search_table_free(rt_search_table *rst);
+
+int rt_compare_tagged_end_indices(const void *a, const void *b);
+
+void rt_search_table_merge_join(const rt_search_table *rst, const rt_tagged_end_index *sorted_end_indices, unsigned int first, unsigned int last, const unsigned char *skip_hashes, rt_search_hit_func hit_func, void *ctx);
+
+unsigned int rt_end_index_set_init(rt_end_index_set *set, unsigned int num_entries);
+
+void rt_end_index_set_add(rt_end_index_set *set, uint64_t end_index, unsigned int hash_number, unsigned int position);
+
+void rt_end_index_set_free(rt_end_index_set *set);
+
+void rt_search_table_hash_join(const rt_search_table *rst, const rt_end_index_set *set, unsigned int first_chain, unsigned int last_chain, const unsigned char *skip_hashes, rt_search_hit_func hit_func, void *ctx);
+
+#endif
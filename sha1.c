@@ -0,0 +1,181 @@
+/*
+ * Rainbow Crackalack: sha1.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Single-block SHA-1 (FIPS 180-4), in scalar and multi-buffer SIMD forms.  The message
+ * words and results are transposed in the same way as in md5.c.  Message words are
+ * the big-endian words of the block, and digest words are to be stored big-endian.
+ */
+
+#include <string.h>
+
+#include "sha1.h"
+
+#define SHA1_ROTL(x, s)	(((x) << (s)) | ((x) >> (32 - (s))))
+
+#define SHA1_F1(x, y, z)	((z) ^ ((x) & ((y) ^ (z))))
+#define SHA1_F2(x, y, z)	((x) ^ (y) ^ (z))
+#define SHA1_F3(x, y, z)	(((x) & (y)) | ((z) & ((x) | (y))))
+
+/* Expands the message schedule in place: W holds the last 16 words, so word t is
+ * stored over word t - 16. */
+#define SHA1_W(W, t, t3, t8, t14) \
+	(W[t] = SHA1_ROTL(W[t3] ^ W[t8] ^ W[t14] ^ W[t], 1))
+
+#define SHA1_STEP(f, k, a, b, c, d, e, x) \
+	(e) += SHA1_ROTL((a), 5) + f((b), (c), (d)) + (k) + (x); \
+	(b) = SHA1_ROTL((b), 30)
+
+/* All 80 SHA-1 steps over the state (a, b, c, d, e) and message words W. */
+#define SHA1_ROUNDS(a, b, c, d, e, W) \
+	SHA1_STEP(SHA1_F1, 0x5a827999, a, b, c, d, e, W[0]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, e, a, b, c, d, W[1]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, d, e, a, b, c, W[2]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, c, d, e, a, b, W[3]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, b, c, d, e, a, W[4]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, a, b, c, d, e, W[5]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, e, a, b, c, d, W[6]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, d, e, a, b, c, W[7]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, c, d, e, a, b, W[8]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, b, c, d, e, a, W[9]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, a, b, c, d, e, W[10]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, e, a, b, c, d, W[11]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, d, e, a, b, c, W[12]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, c, d, e, a, b, W[13]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, b, c, d, e, a, W[14]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, a, b, c, d, e, W[15]); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, e, a, b, c, d, SHA1_W(W, 0, 13, 8, 2)); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, d, e, a, b, c, SHA1_W(W, 1, 14, 9, 3)); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, c, d, e, a, b, SHA1_W(W, 2, 15, 10, 4)); \
+	SHA1_STEP(SHA1_F1, 0x5a827999, b, c, d, e, a, SHA1_W(W, 3, 0, 11, 5)); \
+	 \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, a, b, c, d, e, SHA1_W(W, 4, 1, 12, 6)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, e, a, b, c, d, SHA1_W(W, 5, 2, 13, 7)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, d, e, a, b, c, SHA1_W(W, 6, 3, 14, 8)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, c, d, e, a, b, SHA1_W(W, 7, 4, 15, 9)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, b, c, d, e, a, SHA1_W(W, 8, 5, 0, 10)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, a, b, c, d, e, SHA1_W(W, 9, 6, 1, 11)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, e, a, b, c, d, SHA1_W(W, 10, 7, 2, 12)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, d, e, a, b, c, SHA1_W(W, 11, 8, 3, 13)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, c, d, e, a, b, SHA1_W(W, 12, 9, 4, 14)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, b, c, d, e, a, SHA1_W(W, 13, 10, 5, 15)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, a, b, c, d, e, SHA1_W(W, 14, 11, 6, 0)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, e, a, b, c, d, SHA1_W(W, 15, 12, 7, 1)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, d, e, a, b, c, SHA1_W(W, 0, 13, 8, 2)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, c, d, e, a, b, SHA1_W(W, 1, 14, 9, 3)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, b, c, d, e, a, SHA1_W(W, 2, 15, 10, 4)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, a, b, c, d, e, SHA1_W(W, 3, 0, 11, 5)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, e, a, b, c, d, SHA1_W(W, 4, 1, 12, 6)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, d, e, a, b, c, SHA1_W(W, 5, 2, 13, 7)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, c, d, e, a, b, SHA1_W(W, 6, 3, 14, 8)); \
+	SHA1_STEP(SHA1_F2, 0x6ed9eba1, b, c, d, e, a, SHA1_W(W, 7, 4, 15, 9)); \
+	 \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, a, b, c, d, e, SHA1_W(W, 8, 5, 0, 10)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, e, a, b, c, d, SHA1_W(W, 9, 6, 1, 11)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, d, e, a, b, c, SHA1_W(W, 10, 7, 2, 12)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, c, d, e, a, b, SHA1_W(W, 11, 8, 3, 13)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, b, c, d, e, a, SHA1_W(W, 12, 9, 4, 14)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, a, b, c, d, e, SHA1_W(W, 13, 10, 5, 15)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, e, a, b, c, d, SHA1_W(W, 14, 11, 6, 0)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, d, e, a, b, c, SHA1_W(W, 15, 12, 7, 1)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, c, d, e, a, b, SHA1_W(W, 0, 13, 8, 2)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, b, c, d, e, a, SHA1_W(W, 1, 14, 9, 3)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, a, b, c, d, e, SHA1_W(W, 2, 15, 10, 4)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, e, a, b, c, d, SHA1_W(W, 3, 0, 11, 5)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, d, e, a, b, c, SHA1_W(W, 4, 1, 12, 6)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, c, d, e, a, b, SHA1_W(W, 5, 2, 13, 7)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, b, c, d, e, a, SHA1_W(W, 6, 3, 14, 8)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, a, b, c, d, e, SHA1_W(W, 7, 4, 15, 9)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, e, a, b, c, d, SHA1_W(W, 8, 5, 0, 10)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, d, e, a, b, c, SHA1_W(W, 9, 6, 1, 11)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, c, d, e, a, b, SHA1_W(W, 10, 7, 2, 12)); \
+	SHA1_STEP(SHA1_F3, 0x8f1bbcdc, b, c, d, e, a, SHA1_W(W, 11, 8, 3, 13)); \
+	 \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, a, b, c, d, e, SHA1_W(W, 12, 9, 4, 14)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, e, a, b, c, d, SHA1_W(W, 13, 10, 5, 15)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, d, e, a, b, c, SHA1_W(W, 14, 11, 6, 0)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, c, d, e, a, b, SHA1_W(W, 15, 12, 7, 1)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, b, c, d, e, a, SHA1_W(W, 0, 13, 8, 2)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, a, b, c, d, e, SHA1_W(W, 1, 14, 9, 3)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, e, a, b, c, d, SHA1_W(W, 2, 15, 10, 4)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, d, e, a, b, c, SHA1_W(W, 3, 0, 11, 5)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, c, d, e, a, b, SHA1_W(W, 4, 1, 12, 6)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, b, c, d, e, a, SHA1_W(W, 5, 2, 13, 7)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, a, b, c, d, e, SHA1_W(W, 6, 3, 14, 8)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, e, a, b, c, d, SHA1_W(W, 7, 4, 15, 9)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, d, e, a, b, c, SHA1_W(W, 8, 5, 0, 10)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, c, d, e, a, b, SHA1_W(W, 9, 6, 1, 11)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, b, c, d, e, a, SHA1_W(W, 10, 7, 2, 12)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, a, b, c, d, e, SHA1_W(W, 11, 8, 3, 13)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, e, a, b, c, d, SHA1_W(W, 12, 9, 4, 14)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, d, e, a, b, c, SHA1_W(W, 13, 10, 5, 15)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, c, d, e, a, b, SHA1_W(W, 14, 11, 6, 0)); \
+	SHA1_STEP(SHA1_F2, 0xca62c1d6, b, c, d, e, a, SHA1_W(W, 15, 12, 7, 1));
+
+/* The body of a SHA-1 function for the given type (unsigned int or a vector of
+ * them). */
+#define SHA1_ENCRYPT_BODY(vtype, lanes) \
+  vtype w[16], a, b, c, d, e; \
+  int i = 0; \
+  \
+  for (i = 0; i < 16; i++) \
+    memcpy(&w[i], W + (i * lanes), sizeof(vtype)); \
+  \
+  a = (vtype){0} + 0x67452301; \
+  b = (vtype){0} + 0xefcdab89; \
+  c = (vtype){0} + 0x98badcfe; \
+  d = (vtype){0} + 0x10325476; \
+  e = (vtype){0} + 0xc3d2e1f0; \
+  \
+  SHA1_ROUNDS(a, b, c, d, e, w); \
+  \
+  a += 0x67452301; \
+  b += 0xefcdab89; \
+  c += 0x98badcfe; \
+  d += 0x10325476; \
+  e += 0xc3d2e1f0; \
+  \
+  memcpy(hash + (0 * lanes), &a, sizeof(vtype)); \
+  memcpy(hash + (1 * lanes), &b, sizeof(vtype)); \
+  memcpy(hash + (2 * lanes), &c, sizeof(vtype)); \
+  memcpy(hash + (3 * lanes), &d, sizeof(vtype)); \
+  memcpy(hash + (4 * lanes), &e, sizeof(vtype));
+
+
+/* Runs the SHA-1 compression function on one block, starting from the standard
+ * initial state.  The five digest words are stored in hash. */
+void sha1_encrypt(unsigned int *hash, unsigned int *W) {
+  SHA1_ENCRYPT_BODY(unsigned int, 1)
+}
+
+
+#ifdef CPU_SIMD_SUPPORTED
+
+typedef unsigned int v8ui __attribute__((vector_size(32)));
+typedef unsigned int v16ui __attribute__((vector_size(64)));
+
+__attribute__((target("avx2")))
+void sha1_encrypt_x8(unsigned int *hash, unsigned int *W) {
+  SHA1_ENCRYPT_BODY(v8ui, 8)
+}
+
+__attribute__((target("avx512f")))
+void sha1_encrypt_x16(unsigned int *hash, unsigned int *W) {
+  SHA1_ENCRYPT_BODY(v16ui, 16)
+}
+
+#endif /* CPU_SIMD_SUPPORTED */
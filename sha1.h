@@ -0,0 +1,13 @@
+#ifndef _SHA1_H
+#define _SHA1_H
+
+#include "cpu_features.h"
+
+void sha1_encrypt(unsigned int *hash, unsigned int *W);
+
+#ifdef CPU_SIMD_SUPPORTED
+void sha1_encrypt_x8(unsigned int *hash, unsigned int *W);
+void sha1_encrypt_x16(unsigned int *hash, unsigned int *W);
+#endif
+
+#endif
@@ -10,11 +10,19 @@
 #define HASH_SHA1 4
 
 #define MAX_PLAINTEXT_LEN 16
-#define MAX_HASH_OUTPUT_LEN 16
+#define MAX_HASH_OUTPUT_LEN 20
 #define MAX_CHARSET_LEN 96
 
 #define DEBUG_LEN 32
 
+/* The parameters of the standard NTLM8 and NTLM9 tables (ascii-32-95 charset, table
+ * index 0), which have specialized kernels and CPU functions.  The plaintext space
+ * totals are 95^8 and 95^9, respectively. */
+#define NTLM8_CHAIN_LEN 422000
+#define NTLM8_PLAINTEXT_SPACE_TOTAL 6634204312890625UL
+#define NTLM9_CHAIN_LEN 803000
+#define NTLM9_PLAINTEXT_SPACE_TOTAL 630249409724609375UL
+
 /* Converts a table index to a reduction offset. */
 #define TABLE_INDEX_TO_REDUCTION_OFFSET(_table_index) (_table_index * 65536)
 
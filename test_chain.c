@@ -64,9 +64,13 @@ struct chain_test ntlm_chain_tests[] = {
   {CHARSET_ASCII_32_95, 9, 9, 0, 1000000, 9999UL, 31278606226553517UL},
 };
 
+/* The number of chains cpu_test_chains_batch() puts in one batch.  This is deliberately
+ * not a multiple of the SIMD widths. */
+#define NUM_BATCH_CHAINS 19
+
 
 /* Test a chain using the CPU. */
-int cpu_test_chain(char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned int table_index, unsigned int chain_len, uint64_t start, uint64_t expected_end) {
+int cpu_test_chain(unsigned int hash_type, char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned int table_index, unsigned int chain_len, uint64_t start, uint64_t expected_end) {
   uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
   uint64_t computed_end = 0, plaintext_space_total = 0;
   unsigned char hash[16] = {0};
@@ -76,7 +80,7 @@ int cpu_test_chain(char *charset, unsigned int plaintext_len_min, unsigned int p
 
   plaintext_space_total = fill_plaintext_space_table(strlen(charset), plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index);
 
-  computed_end = generate_rainbow_chain(HASH_NTLM, charset, strlen(charset), plaintext_len_min, plaintext_len_max, TABLE_INDEX_TO_REDUCTION_OFFSET(table_index), chain_len, start, plaintext_space_up_to_index, plaintext_space_total, plaintext, &plaintext_len, hash, &hash_len);
+  computed_end = generate_rainbow_chain(hash_type, charset, strlen(charset), plaintext_len_min, plaintext_len_max, TABLE_INDEX_TO_REDUCTION_OFFSET(table_index), chain_len, start, plaintext_space_up_to_index, plaintext_space_total, plaintext, &plaintext_len, hash, &hash_len);
 
   if (computed_end != expected_end) {
     fprintf(stderr, "\n\nCPU error:\n\tExpected chain end: %"PRIu64"\n\tComputed chain end: %"PRIu64"\n\n", expected_end, computed_end);
@@ -87,6 +91,45 @@ int cpu_test_chain(char *charset, unsigned int plaintext_len_min, unsigned int p
 }
 
 
+/* Test a batch of chains using the CPU's batched chain walker.  The first chain in the
+ * batch is the test vector, and the others are checked against the scalar code.  Long
+ * chains are only tested on their own, as the scalar checks would take too long. */
+int cpu_test_chains_batch(unsigned int hash_type, char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned int table_index, unsigned int chain_len, uint64_t start, uint64_t expected_end) {
+  uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
+  uint64_t indices[NUM_BATCH_CHAINS] = {0};
+  uint64_t plaintext_space_total = 0, expected = 0;
+  unsigned char hash[16] = {0};
+  char plaintext[MAX_PLAINTEXT_LEN] = {0};
+  unsigned int hash_len = sizeof(hash), plaintext_len = sizeof(plaintext), num_chains = NUM_BATCH_CHAINS, i = 0;
+  int test_passed = 1;
+
+
+  plaintext_space_total = fill_plaintext_space_table(strlen(charset), plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index);
+
+  if (chain_len > 10000)
+    num_chains = 1;
+
+  for (i = 0; i < num_chains; i++)
+    indices[i] = (start + (i * 7919)) % plaintext_space_total;
+
+  generate_rainbow_chains(hash_type, charset, strlen(charset), plaintext_len_min, plaintext_len_max, TABLE_INDEX_TO_REDUCTION_OFFSET(table_index), 0, chain_len, indices, num_chains, plaintext_space_up_to_index, plaintext_space_total);
+
+  for (i = 0; i < num_chains; i++) {
+    if (i == 0)
+      expected = expected_end;
+    else
+      expected = generate_rainbow_chain(hash_type, charset, strlen(charset), plaintext_len_min, plaintext_len_max, TABLE_INDEX_TO_REDUCTION_OFFSET(table_index), chain_len, (start + (i * 7919)) % plaintext_space_total, plaintext_space_up_to_index, plaintext_space_total, plaintext, &plaintext_len, hash, &hash_len);
+
+    if (indices[i] != expected) {
+      fprintf(stderr, "\n\nCPU batch error (chain #%u):\n\tExpected chain end: %"PRIu64"\n\tComputed chain end: %"PRIu64"\n\n", i, expected, indices[i]);
+      test_passed = 0;
+    }
+  }
+
+  return test_passed;
+}
+
+
 /* Test a chain using the GPU. */
 int gpu_test_chain(cl_device_id device, cl_context context, cl_kernel kernel, char *charset, unsigned int plaintext_len_min, unsigned int plaintext_len_max, unsigned int table_index, unsigned int chain_len, uint64_t start, uint64_t expected_end) {
   CLMAKETESTVARS();
@@ -153,6 +196,20 @@ int gpu_test_chain(cl_device_id device, cl_context context, cl_kernel kernel, ch
 }
 
 
+/* Runs the LM chain tests on the CPU only, with both chain walkers. */
+int test_chain_lm_cpu() {
+  int tests_passed = 1;
+  unsigned int i = 0;
+
+  for (i = 0; i < (sizeof(lm_chain_tests) / sizeof(struct chain_test)); i++) {
+    tests_passed &= cpu_test_chain(HASH_LM, lm_chain_tests[i].charset, lm_chain_tests[i].plaintext_len_min, lm_chain_tests[i].plaintext_len_max, lm_chain_tests[i].table_index, lm_chain_tests[i].chain_len, lm_chain_tests[i].start, lm_chain_tests[i].end);
+    tests_passed &= cpu_test_chains_batch(HASH_LM, lm_chain_tests[i].charset, lm_chain_tests[i].plaintext_len_min, lm_chain_tests[i].plaintext_len_max, lm_chain_tests[i].table_index, lm_chain_tests[i].chain_len, lm_chain_tests[i].start, lm_chain_tests[i].end);
+  }
+
+  return tests_passed;
+}
+
+
 int test_chain(cl_device_id device, cl_context context, cl_kernel kernel, unsigned int hash_type) {
   int tests_passed = 1;
   unsigned int i = 0;
@@ -164,7 +221,8 @@ int test_chain(cl_device_id device, cl_context context, cl_kernel kernel, unsign
   } else if (hash_type == HASH_NTLM) {
     for (i = 0; i < (sizeof(ntlm_chain_tests) / sizeof(struct chain_test)); i++) {
       tests_passed &= gpu_test_chain(device, context, kernel, ntlm_chain_tests[i].charset, ntlm_chain_tests[i].plaintext_len_min, ntlm_chain_tests[i].plaintext_len_max, ntlm_chain_tests[i].table_index, ntlm_chain_tests[i].chain_len, ntlm_chain_tests[i].start, ntlm_chain_tests[i].end);
-      tests_passed &= cpu_test_chain(ntlm_chain_tests[i].charset, ntlm_chain_tests[i].plaintext_len_min, ntlm_chain_tests[i].plaintext_len_max, ntlm_chain_tests[i].table_index, ntlm_chain_tests[i].chain_len, ntlm_chain_tests[i].start, ntlm_chain_tests[i].end);
+      tests_passed &= cpu_test_chain(HASH_NTLM, ntlm_chain_tests[i].charset, ntlm_chain_tests[i].plaintext_len_min, ntlm_chain_tests[i].plaintext_len_max, ntlm_chain_tests[i].table_index, ntlm_chain_tests[i].chain_len, ntlm_chain_tests[i].start, ntlm_chain_tests[i].end);
+      tests_passed &= cpu_test_chains_batch(HASH_NTLM, ntlm_chain_tests[i].charset, ntlm_chain_tests[i].plaintext_len_min, ntlm_chain_tests[i].plaintext_len_max, ntlm_chain_tests[i].table_index, ntlm_chain_tests[i].chain_len, ntlm_chain_tests[i].start, ntlm_chain_tests[i].end);
     }
   }
 
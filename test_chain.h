@@ -1,6 +1,8 @@
 #ifndef TEST_CHAIN_H
 #define TEST_CHAIN_H
 
+int test_chain_lm_cpu();
+
 int test_chain(cl_device_id device, cl_context context, cl_kernel kernel, unsigned int hash_type);
 
 #endif
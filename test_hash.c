@@ -20,7 +20,9 @@
 
 #include "opencl_setup.h"
 
+#include "cpu_features.h"
 #include "cpu_rt_functions.h"
+#include "hash_provider.h"
 #include "misc.h"
 #include "shared.h"
 #include "test_shared.h"
@@ -63,6 +65,43 @@ struct hash_test ntlm_hash_tests[] = {
   {"Holiday!1234", "fddf95b2194203ddc84d53e822510005"},
 };
 
+struct hash_test md5_hash_tests[] = {
+  {"",             "d41d8cd98f00b204e9800998ecf8427e"},
+  {"12345",        "827ccb0eea8a706c4c34a16891f84e7b"},
+  {"abc123",       "e99a18c428cb38d5f260853678922e03"},
+  {"password",     "5f4dcc3b5aa765d61d8327deb882cf99"},
+  {"computer",     "df53ca268240ca76670c8566ee54568a"},
+  {"123456",       "e10adc3949ba59abbe56e057f20f883e"},
+  {"tigger",       "f78f2477e949bee2d12a2c540fb6084f"},
+  {"1234",         "81dc9bdb52d04dc20036dbd8313ed055"},
+  {"Hockey7!",     "b30395c64a6e6fb6cb16e967b05e038c"},
+  {"C1t1z3n#",     "7b0fc722c6486776a87636b5f4dd8a01"},
+  {"London101#",   "6d90fff0086990a4db05f0404720d973"},
+  {"Holiday!1234", "19077458c6ba484493a7cfc820cab1de"},
+};
+
+struct hash_test sha1_hash_tests[] = {
+  {"",             "da39a3ee5e6b4b0d3255bfef95601890afd80709"},
+  {"12345",        "8cb2237d0679ca88db6464eac60da96345513964"},
+  {"abc123",       "6367c48dd193d56ea7b0baad25b19455e529f5ee"},
+  {"password",     "5baa61e4c9b93f3f0682250b6cf8331b7ee68fd8"},
+  {"computer",     "c60266a8adad2f8ee67d793b4fd3fd0ffd73cc61"},
+  {"123456",       "7c4a8d09ca3762af61e59520943dc26494f8941b"},
+  {"tigger",       "6c616f7c2d2fde9018a09f06eaefcfc7582bc7ba"},
+  {"1234",         "7110eda4d09e062aa5e4a390b0a572ac0d2c0220"},
+  {"Hockey7!",     "0bd06f44f3249e81b4bfec09e9622dc217437461"},
+  {"C1t1z3n#",     "4f6f3756d338daa497e830512608e10e9afcf1d4"},
+  {"London101#",   "5041738866145baaa0a9b79912ed2046b51da574"},
+  {"Holiday!1234", "62ff8db46f24c1a5a89da5280df7792e3cd1c224"},
+};
+
+/* The number of plaintexts hashed in one batch by cpu_test_hash_ntlm_many().  This is
+ * deliberately not a multiple of the SIMD widths, so partial batches get tested. */
+#define NUM_NTLM_MANY_TESTS 101
+
+/* The most test vectors that cpu_test_hash_provider() will check. */
+#define MAX_NUM_HASH_TESTS 32
+
 
 /* Creates and tests a hash using the CPU. */
 int cpu_test_hash_ntlm(char *input, char *expected_output_hex) {
@@ -82,6 +121,94 @@ int cpu_test_hash_ntlm(char *input, char *expected_output_hex) {
 }
 
 
+/* Hashes all NTLM test vectors, plus a set of pseudo-random plaintexts, in one batch
+ * at each SIMD level this CPU supports, and compares them to the scalar results. */
+int cpu_test_hash_ntlm_many() {
+  char plaintexts[NUM_NTLM_MANY_TESTS * MAX_PLAINTEXT_LEN] = {0};
+  unsigned char hashes[NUM_NTLM_MANY_TESTS * MAX_HASH_OUTPUT_LEN] = {0}, expected_hash[16] = {0};
+  char hash_hex[(16 * 2) + 1] = {0};
+  unsigned int plaintext_lens[NUM_NTLM_MANY_TESTS] = {0};
+  unsigned int num_vectors = sizeof(ntlm_hash_tests) / sizeof(struct hash_test), level = 0, original_level = get_simd_level(), i = 0, j = 0, x = 1;
+  int tests_passed = 1;
+
+
+  for (i = 0; i < NUM_NTLM_MANY_TESTS; i++) {
+    if (i < num_vectors) {
+      plaintext_lens[i] = strlen(ntlm_hash_tests[i].input);
+      memcpy(plaintexts + (i * MAX_PLAINTEXT_LEN), ntlm_hash_tests[i].input, plaintext_lens[i]);
+    } else {
+      plaintext_lens[i] = i % MAX_PLAINTEXT_LEN;
+      for (j = 0; j < plaintext_lens[i]; j++) {
+	x = (x * 1103515245) + 12345;
+	plaintexts[(i * MAX_PLAINTEXT_LEN) + j] = 32 + ((x >> 16) % 95);
+      }
+    }
+  }
+
+  for (level = SIMD_SCALAR; level <= get_simd_level_supported(); level++) {
+    set_simd_level(level);
+    ntlm_hash_many(plaintexts, plaintext_lens, NUM_NTLM_MANY_TESTS, hashes);
+
+    for (i = 0; i < NUM_NTLM_MANY_TESTS; i++) {
+      ntlm_hash(plaintexts + (i * MAX_PLAINTEXT_LEN), plaintext_lens[i], expected_hash);
+      bytes_to_hex(hashes + (i * MAX_HASH_OUTPUT_LEN), 16, hash_hex, sizeof(hash_hex));
+
+      if ((memcmp(hashes + (i * MAX_HASH_OUTPUT_LEN), expected_hash, sizeof(expected_hash)) != 0) || ((i < num_vectors) && (strcmp(hash_hex, ntlm_hash_tests[i].output) != 0))) {
+	printf("\n\nCPU Error (%s):\n\tPlaintext:     %.*s\n\tComputed hash: %s\n\n", get_simd_level_name(level), plaintext_lens[i], plaintexts + (i * MAX_PLAINTEXT_LEN), hash_hex);
+	tests_passed = 0;
+      }
+    }
+  }
+
+  set_simd_level(original_level);
+  return tests_passed;
+}
+
+
+/* Checks that the CPU hash provider for the specified hash type produces the expected
+ * hashes for the test vectors, both singly and in a batch at each SIMD level this CPU
+ * supports. */
+int cpu_test_hash_provider(unsigned int hash_type, struct hash_test *tests, unsigned int num_tests) {
+  const hash_provider *hp = get_hash_provider(hash_type);
+  char plaintexts[MAX_NUM_HASH_TESTS * MAX_PLAINTEXT_LEN] = {0};
+  unsigned char hashes[MAX_NUM_HASH_TESTS * MAX_HASH_OUTPUT_LEN] = {0}, hash[MAX_HASH_OUTPUT_LEN] = {0};
+  char hash_hex[(MAX_HASH_OUTPUT_LEN * 2) + 1] = {0}, hashes_hex[(MAX_HASH_OUTPUT_LEN * 2) + 1] = {0};
+  unsigned int plaintext_lens[MAX_NUM_HASH_TESTS] = {0};
+  unsigned int level = 0, original_level = get_simd_level(), i = 0;
+  int tests_passed = 1;
+
+
+  if ((hp == NULL) || (hp->hash_type != hash_type) || (num_tests > MAX_NUM_HASH_TESTS)) {
+    printf("\n\nCPU Error: no valid hash provider for hash type %u.\n\n", hash_type);
+    return 0;
+  }
+
+  for (i = 0; i < num_tests; i++) {
+    plaintext_lens[i] = strlen(tests[i].input);
+    memcpy(plaintexts + (i * MAX_PLAINTEXT_LEN), tests[i].input, plaintext_lens[i]);
+  }
+
+  for (level = SIMD_SCALAR; level <= get_simd_level_supported(); level++) {
+    set_simd_level(level);
+    hp->hash_many(plaintexts, plaintext_lens, num_tests, hashes);
+
+    for (i = 0; i < num_tests; i++) {
+      hp->hash(tests[i].input, plaintext_lens[i], hash);
+      bytes_to_hex(hash, hp->hash_len, hash_hex, sizeof(hash_hex));
+      bytes_to_hex(hashes + (i * MAX_HASH_OUTPUT_LEN), hp->hash_len, hashes_hex, sizeof(hashes_hex));
+
+      if ((strcmp(hash_hex, tests[i].output) != 0) || (strcmp(hashes_hex, tests[i].output) != 0)) {
+	printf("\n\nCPU Error (%s provider, %s):\n\tPlaintext:       %s\n\tExpected hash:   %s\n\tComputed hash:   %s\n\tBatch hash:      %s\n\n", hp->name, get_simd_level_name(level), tests[i].input, tests[i].output, hash_hex, hashes_hex);
+	tests_passed = 0;
+      }
+    }
+  }
+
+  set_simd_level(original_level);
+  return tests_passed;
+}
+
+
 /* Creates and tests a hash using the GPU. */
 int gpu_test_hash(cl_device_id device, cl_context context, cl_kernel kernel, char *_input, char *expected_output_hex) {
   CLMAKETESTVARS();
@@ -168,6 +295,13 @@ int gpu_test_hash(cl_device_id device, cl_context context, cl_kernel kernel, cha
 }
 
 
+/* Runs the LM hash tests on the CPU only (through its hash provider, at each SIMD
+ * level). */
+int test_hash_lm_cpu() {
+  return cpu_test_hash_provider(HASH_LM, lm_hash_tests, sizeof(lm_hash_tests) / sizeof(struct hash_test));
+}
+
+
 int test_hash(cl_device_id device, cl_context context, cl_kernel kernel, unsigned int hash_type) {
   int tests_passed = 1;
   unsigned int i = 0;
@@ -180,6 +314,16 @@ int test_hash(cl_device_id device, cl_context context, cl_kernel kernel, unsigne
       tests_passed &= gpu_test_hash(device, context, kernel, ntlm_hash_tests[i].input, ntlm_hash_tests[i].output);
       tests_passed &= cpu_test_hash_ntlm(ntlm_hash_tests[i].input, ntlm_hash_tests[i].output);
     }
+    tests_passed &= cpu_test_hash_ntlm_many();
+    tests_passed &= cpu_test_hash_provider(HASH_NTLM, ntlm_hash_tests, sizeof(ntlm_hash_tests) / sizeof(struct hash_test));
+  } else if (hash_type == HASH_MD5) {
+    for (i = 0; i < (sizeof(md5_hash_tests) / sizeof(struct hash_test)); i++)
+      tests_passed &= gpu_test_hash(device, context, kernel, md5_hash_tests[i].input, md5_hash_tests[i].output);
+    tests_passed &= cpu_test_hash_provider(HASH_MD5, md5_hash_tests, sizeof(md5_hash_tests) / sizeof(struct hash_test));
+  } else if (hash_type == HASH_SHA1) {
+    for (i = 0; i < (sizeof(sha1_hash_tests) / sizeof(struct hash_test)); i++)
+      tests_passed &= gpu_test_hash(device, context, kernel, sha1_hash_tests[i].input, sha1_hash_tests[i].output);
+    tests_passed &= cpu_test_hash_provider(HASH_SHA1, sha1_hash_tests, sizeof(sha1_hash_tests) / sizeof(struct hash_test));
   } else {
     fprintf(stderr, "Error: unimplemented hash: %u\n", hash_type);
     tests_passed = 0;
@@ -1,6 +1,8 @@
 #ifndef TEST_HASH_H
 #define TEST_HASH_H
 
+int test_hash_lm_cpu();
+
 int test_hash(cl_device_id device, cl_context context, cl_kernel kernel, unsigned int hash_type);
 
 #endif
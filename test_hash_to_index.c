@@ -22,11 +22,17 @@
 #include "opencl_setup.h"
 
 #include "cpu_rt_functions.h"
+#include "fast_div.h"
 #include "misc.h"
 #include "shared.h"
 #include "test_shared.h"
 #include "test_hash_to_index.h"
 
+/* The charsets and maximum plaintext lengths whose plaintext space totals are checked
+ * by cpu_test_fast_div(). */
+#define NUM_FAST_DIV_TEST_CHARSETS 6
+#define NUM_FAST_DIV_TEST_LENGTHS 9
+
 
 struct h2i_test {
   char hash[MAX_HASH_OUTPUT_LEN * 2];
@@ -59,14 +65,64 @@ int cpu_test_h2i(char *hash_hex, uint64_t plaintext_space_total, unsigned int ta
   unsigned char hash[MAX_HASH_OUTPUT_LEN] = {0};
   unsigned int hash_len = hex_to_bytes(hash_hex, sizeof(hash), hash);
   uint64_t computed_index = hash_to_index(hash, hash_len, TABLE_INDEX_TO_REDUCTION_OFFSET(table_index), plaintext_space_total, pos);
+  fast_div plaintext_space_total_div;
 
 
-  if (computed_index == expected_index)
-    return 1;
-  else {
+  if (computed_index != expected_index) {
     printf("\n\nCPU error:\n\tExpected index: %"PRIu64"\n\tComputed index: %"PRIu64"\n", expected_index, computed_index);
     return 0;
   }
+
+  /* Check the reciprocal version as well. */
+  fast_div_init(&plaintext_space_total_div, plaintext_space_total);
+  computed_index = hash_to_index_fast_div(hash, TABLE_INDEX_TO_REDUCTION_OFFSET(table_index), &plaintext_space_total_div, pos);
+  if (computed_index != expected_index) {
+    printf("\n\nCPU error (fast_div):\n\tExpected index: %"PRIu64"\n\tComputed index: %"PRIu64"\n", expected_index, computed_index);
+    return 0;
+  }
+
+  return 1;
+}
+
+
+/* Checks fast_div against the division operator for the plaintext space totals and
+ * charset lengths of every charset, along with some other edge-case divisors. */
+int cpu_test_fast_div() {
+  uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
+  uint64_t divisors[(NUM_FAST_DIV_TEST_CHARSETS * (NUM_FAST_DIV_TEST_LENGTHS + 1)) + 4] = {1, 2, 0x8000000000000001UL, UINT64_MAX};
+  uint64_t numerators[] = {0, 1, 94, 95, 96, 0x7fffffffffffffffUL, 0x8000000000000000UL, UINT64_MAX - 1, UINT64_MAX, 0};
+  char *charsets[NUM_FAST_DIV_TEST_CHARSETS] = {CHARSET_NUMERIC, CHARSET_ALPHA, CHARSET_ALPHA_NUMERIC, CHARSET_MIXALPHA_NUMERIC, CHARSET_ALPHA_NUMERIC_SYMBOL32_SPACE, CHARSET_ASCII_32_95};
+  unsigned int num_divisors = 4, num_numerators = sizeof(numerators) / sizeof(uint64_t), i = 0, j = 0;
+  uint64_t lcg = 0xfedcba9876543210UL, n = 0;
+  fast_div fd;
+
+
+  for (i = 0; i < NUM_FAST_DIV_TEST_CHARSETS; i++) {
+    divisors[num_divisors++] = strlen(charsets[i]);
+    for (j = 1; j <= NUM_FAST_DIV_TEST_LENGTHS; j++)
+      divisors[num_divisors++] = fill_plaintext_space_table(strlen(charsets[i]), 1, j, plaintext_space_up_to_index);
+  }
+
+  for (i = 0; i < num_divisors; i++) {
+    fast_div_init(&fd, divisors[i]);
+    for (j = 0; j < num_numerators + 1000; j++) {
+      if (j < num_numerators - 1)
+	n = numerators[j];
+      else if (j == num_numerators - 1)
+	n = divisors[i] - 1;
+      else {
+	lcg = (lcg * 6364136223846793005UL) + 1442695040888963407UL;
+	n = lcg >> (j % 64);
+      }
+
+      if ((fast_div_quotient(n, &fd) != (n / divisors[i])) || (fast_div_remainder(n, &fd) != (n % divisors[i]))) {
+	printf("\n\nCPU error (fast_div):\n\tDivisor: %"PRIu64"\n\tNumerator: %"PRIu64"\n\tExpected: %"PRIu64" r %"PRIu64"\n\tComputed: %"PRIu64" r %"PRIu64"\n", divisors[i], n, n / divisors[i], n % divisors[i], fast_div_quotient(n, &fd), fast_div_remainder(n, &fd));
+	return 0;
+      }
+    }
+  }
+
+  return 1;
 }
 
 
@@ -180,6 +236,8 @@ int test_h2i(cl_device_id device, cl_context context, cl_kernel kernel, unsigned
 
       tests_passed &= cpu_test_h2i(ntlm_h2i_tests[i].hash, plaintext_space_total, ntlm_h2i_tests[i].table_index, ntlm_h2i_tests[i].pos, ntlm_h2i_tests[i].index);
     }
+
+    tests_passed &= cpu_test_fast_div();
   }
 
   return tests_passed;
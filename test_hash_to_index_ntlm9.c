@@ -21,6 +21,7 @@
 
 #include "opencl_setup.h"
 
+#include "charset.h"
 #include "cpu_rt_functions.h"
 #include "misc.h"
 #include "shared.h"
@@ -47,6 +48,12 @@ int cpu_test_h2i_ntlm9(char *hash_hex, uint64_t plaintext_space_total, unsigned
   uint64_t computed_index = hash_to_index(hash, hash_len, 0, plaintext_space_total, pos);
 
 
+  /* The specialized function must agree with the generic one. */
+  if ((computed_index == expected_index) && (hash_to_index_ntlm9(hash, 0, pos) != expected_index)) {
+    printf("\n\nCPU error:\n\tExpected index: %"PRIu64"\n\tComputed index (hash_to_index_ntlm9): %"PRIu64"\n", expected_index, hash_to_index_ntlm9(hash, 0, pos));
+    return 0;
+  }
+
   if (computed_index == expected_index)
     return 1;
   else {
@@ -56,6 +63,45 @@ int cpu_test_h2i_ntlm9(char *hash_hex, uint64_t plaintext_space_total, unsigned
 }
 
 
+/* Checks that the specialized NTLM8/NTLM9 hash-to-index function gives the same
+ * results as the generic one for hashes on either side of every multiple of the
+ * plaintext space (where the reciprocal multiplication is most likely to be off by
+ * one), and for the largest hash values, where adding the position overflows. */
+int cpu_test_h2i_fixed_len(unsigned int plaintext_len) {
+  uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
+  unsigned char hash[MAX_HASH_OUTPUT_LEN] = {0};
+  unsigned int positions[] = {0, 1, 65535, 802999};
+  unsigned int i = 0, j = 0, k = 0;
+  uint64_t plaintext_space_total = 0, hash_value = 0, expected_index = 0, computed_index = 0;
+  int delta = 0;
+  reduction_context rc;
+
+
+  plaintext_space_total = fill_plaintext_space_table(CHARSET_ASCII_32_95_LEN, plaintext_len, plaintext_len, plaintext_space_up_to_index);
+  init_reduction_context(&rc, HASH_NTLM, CHARSET_ASCII_32_95, CHARSET_ASCII_32_95_LEN, plaintext_len, plaintext_len, plaintext_space_total);
+
+  for (i = 0; i <= (UINT64_MAX / plaintext_space_total) + 1; i++) {
+    for (delta = -2; delta <= 2; delta++) {
+      hash_value = (i <= (UINT64_MAX / plaintext_space_total)) ? (plaintext_space_total * i) + delta : UINT64_MAX + delta - 2;
+
+      for (k = 0; k < 8; k++)
+	hash[k] = (hash_value >> (k * 8)) & 0xff;
+
+      for (j = 0; j < (sizeof(positions) / sizeof(unsigned int)); j++) {
+	expected_index = hash_to_index(hash, 16, TABLE_INDEX_TO_REDUCTION_OFFSET(1), plaintext_space_total, positions[j]);
+	computed_index = step_hash_to_index(&rc, hash, TABLE_INDEX_TO_REDUCTION_OFFSET(1), positions[j]);
+	if (computed_index != expected_index) {
+	  printf("\n\nCPU error (NTLM%u):\n\tHash value: %"PRIu64"\n\tPosition: %u\n\tExpected index: %"PRIu64"\n\tComputed index: %"PRIu64"\n", plaintext_len, hash_value, positions[j], expected_index, computed_index);
+	  return 0;
+	}
+      }
+    }
+  }
+
+  return 1;
+}
+
+
 int gpu_test_h2i_ntlm9(cl_device_id device, cl_context context, cl_kernel kernel, char *hash_hex, unsigned int pos, uint64_t expected_index) {
   CLMAKETESTVARS();
   int test_passed = 0;
@@ -126,5 +172,8 @@ int test_h2i_ntlm9(cl_device_id device, cl_context context, cl_kernel kernel) {
     tests_passed &= cpu_test_h2i_ntlm9(ntlm9_h2i_tests[i].hash, plaintext_space_total, ntlm9_h2i_tests[i].pos, ntlm9_h2i_tests[i].index);
   }
 
+  tests_passed &= cpu_test_h2i_fixed_len(8);
+  tests_passed &= cpu_test_h2i_fixed_len(9);
+
   return tests_passed;
 }
@@ -22,6 +22,7 @@
 #include "opencl_setup.h"
 
 #include "cpu_rt_functions.h"
+#include "fast_div.h"
 #include "misc.h"
 #include "shared.h"
 #include "test_shared.h"
@@ -59,17 +60,27 @@ int cpu_test_index_to_plaintext(char *charset, cl_uint plaintext_len_min, cl_uin
   uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
   char computed_plaintext[MAX_PLAINTEXT_LEN] = {0};
   unsigned int computed_plaintext_len = 0;
+  fast_div charset_len_div;
 
 
   fill_plaintext_space_table(strlen(charset), plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index);
 
   index_to_plaintext(index, charset, strlen(charset), plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, computed_plaintext, &computed_plaintext_len);
-  if (strcmp(computed_plaintext, expected_plaintext) == 0)
-    return 1;
-  else {
+  if (strcmp(computed_plaintext, expected_plaintext) != 0) {
     printf("\n\nCPU error:\n\tIndex: %"PRIu64"\n\tExpected: [%"PRIu64"][%s]\n\tCalculated: [%u][%s]\n\n", index, strlen(expected_plaintext), expected_plaintext, computed_plaintext_len, computed_plaintext);
     return 0;
   }
+
+  /* Check the reciprocal version as well. */
+  memset(computed_plaintext, 0, sizeof(computed_plaintext));
+  fast_div_init(&charset_len_div, strlen(charset));
+  index_to_plaintext_fast_div(index, charset, &charset_len_div, plaintext_len_min, plaintext_len_max, plaintext_space_up_to_index, computed_plaintext, &computed_plaintext_len);
+  if (strcmp(computed_plaintext, expected_plaintext) != 0) {
+    printf("\n\nCPU error (fast_div):\n\tIndex: %"PRIu64"\n\tExpected: [%"PRIu64"][%s]\n\tCalculated: [%u][%s]\n\n", index, strlen(expected_plaintext), expected_plaintext, computed_plaintext_len, computed_plaintext);
+    return 0;
+  }
+
+  return 1;
 }
 
 
@@ -21,12 +21,16 @@
 
 #include "opencl_setup.h"
 
+#include "charset.h"
 #include "cpu_rt_functions.h"
 #include "misc.h"
 #include "shared.h"
 #include "test_shared.h"
 #include "test_index_to_plaintext_ntlm9.h"
 
+/* The number of pseudo-random indices to check in cpu_test_index_to_plaintext_fixed_len(). */
+#define NUM_FIXED_LEN_I2P_TESTS 100000
+
 struct i2p_ntlm9_test {
   cl_ulong index;
   char expected_plaintext[MAX_PLAINTEXT_LEN];
@@ -38,6 +42,65 @@ struct i2p_ntlm9_test i2p_ntlm9_tests[] = {
 
 
 
+int cpu_test_index_to_plaintext_ntlm9(cl_ulong index, char *expected_plaintext) {
+  char computed_plaintext[MAX_PLAINTEXT_LEN] = {0};
+
+
+  index_to_plaintext_ntlm9(index, computed_plaintext);
+  if (strcmp(computed_plaintext, expected_plaintext) == 0)
+    return 1;
+  else {
+    printf("\n\nCPU error:\n\tIndex: %"PRIu64"\n\tExpected: [%s]\n\tCalculated: [%s]\n\n", index, expected_plaintext, computed_plaintext);
+    return 0;
+  }
+}
+
+
+/* Checks that the specialized NTLM8/NTLM9 index-to-plaintext function gives the same
+ * results as the generic one.  The indices tested are those on either side of each
+ * power of 95 (where the reciprocal multiplications are most likely to be off by one),
+ * the end of the plaintext space, and a set of pseudo-random indices. */
+int cpu_test_index_to_plaintext_fixed_len(unsigned int plaintext_len) {
+  uint64_t plaintext_space_up_to_index[MAX_PLAINTEXT_LEN] = {0};
+  char expected_plaintext[MAX_PLAINTEXT_LEN] = {0}, computed_plaintext[MAX_PLAINTEXT_LEN] = {0};
+  unsigned int expected_plaintext_len = 0, computed_plaintext_len = 0, i = 0;
+  uint64_t plaintext_space_total = 0, index = 0, power = 1, lcg = 0x123456789abcdefUL;
+  reduction_context rc;
+
+
+  plaintext_space_total = fill_plaintext_space_table(CHARSET_ASCII_32_95_LEN, plaintext_len, plaintext_len, plaintext_space_up_to_index);
+  init_reduction_context(&rc, HASH_NTLM, CHARSET_ASCII_32_95, CHARSET_ASCII_32_95_LEN, plaintext_len, plaintext_len, plaintext_space_total);
+
+  for (i = 0; i < NUM_FIXED_LEN_I2P_TESTS + (plaintext_len * 4); i++) {
+    if (i < plaintext_len * 4) {  /* Boundaries: 95^k - 1, 95^k, (94 * 95^k) + 1, and the last index. */
+      if ((i % 4) == 0)
+	index = power - 1;
+      else if ((i % 4) == 1)
+	index = power;
+      else if ((i % 4) == 2)
+	index = (power * 94) + 1;
+      else {
+	index = plaintext_space_total - 1 - (i / 4);
+	power *= 95;
+      }
+    } else {
+      lcg = (lcg * 6364136223846793005UL) + 1442695040888963407UL;
+      index = lcg % plaintext_space_total;
+    }
+
+    index_to_plaintext(index, CHARSET_ASCII_32_95, CHARSET_ASCII_32_95_LEN, plaintext_len, plaintext_len, plaintext_space_up_to_index, expected_plaintext, &expected_plaintext_len);
+    step_index_to_plaintext(&rc, index, CHARSET_ASCII_32_95, plaintext_len, plaintext_len, plaintext_space_up_to_index, computed_plaintext, &computed_plaintext_len);
+
+    if ((computed_plaintext_len != expected_plaintext_len) || (strcmp(computed_plaintext, expected_plaintext) != 0)) {
+      printf("\n\nCPU error (NTLM%u):\n\tIndex: %"PRIu64"\n\tExpected: [%u][%s]\n\tCalculated: [%u][%s]\n\n", plaintext_len, index, expected_plaintext_len, expected_plaintext, computed_plaintext_len, computed_plaintext);
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+
 int gpu_test_index_to_plaintext_ntlm9(cl_device_id device, cl_context context, cl_kernel kernel, cl_ulong index, char *expected_plaintext) {
   CLMAKETESTVARS();
   int test_passed = 0;
@@ -85,7 +148,12 @@ int test_index_to_plaintext_ntlm9(cl_device_id device, cl_context context, cl_ke
 
   for (i = 0; i < (sizeof(i2p_ntlm9_tests) / sizeof(struct i2p_ntlm9_test)); i++) {
     tests_passed &= gpu_test_index_to_plaintext_ntlm9(device, context, kernel, i2p_ntlm9_tests[i].index, i2p_ntlm9_tests[i].expected_plaintext);
+
+    tests_passed &= cpu_test_index_to_plaintext_ntlm9(i2p_ntlm9_tests[i].index, i2p_ntlm9_tests[i].expected_plaintext);
   }
 
+  tests_passed &= cpu_test_index_to_plaintext_fixed_len(8);
+  tests_passed &= cpu_test_index_to_plaintext_fixed_len(9);
+
   return tests_passed;
 }
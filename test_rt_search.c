@@ -0,0 +1,332 @@
+/*
+ * Rainbow Crackalack: test_rt_search.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu_features.h"
+#include "rt_search.h"
+#include "test_rt_search.h"
+
+
+/* Table sizes around the node and level boundaries of the search tree. */
+static unsigned int rt_search_test_sizes[] = {1, 7, 8, 9, 63, 64, 65, 511, 512, 513, 4097, 100003};
+
+
+/* Builds a sorted table with num_chains chains (with some duplicate end indices), and
+ * checks that searching it (one end index at a time and in batches) finds the same
+ * positions as a plain binary search, both for every end index in the table and for
+ * the values next to them.  The second half of the table's end indices are spread
+ * out by the specified factor, so that they are distributed unevenly over the prefix
+ * directory's buckets. */
+static int cpu_test_rt_search(unsigned int num_chains, uint64_t spread) {
+  uint64_t *rainbow_table = NULL, *end_indices = NULL, *queries = NULL;
+  uint64_t end_index = 0, start = 0, x = 1, gap = 0;
+  unsigned int i = 0, j = 0, low = 0, high = 0, mid = 0, pos = 0, found = 0, *batch_positions = NULL;
+  rt_search_table rst;
+  int test_passed = 1;
+
+
+  rainbow_table = calloc(num_chains * 2, sizeof(uint64_t));
+  end_indices = calloc(num_chains, sizeof(uint64_t));
+  queries = calloc(num_chains * 3, sizeof(uint64_t));
+  batch_positions = calloc(num_chains * 3, sizeof(unsigned int));
+  if ((rainbow_table == NULL) || (end_indices == NULL) || (queries == NULL) || (batch_positions == NULL)) {
+    fprintf(stderr, "Failed to allocate test table.\n");
+    exit(-1);
+  }
+
+  /* Each end index is 0, 1, or 2 (times the spread) more than the previous one. */
+  for (i = 0; i < num_chains; i++) {
+    x = (x * 6364136223846793005ULL) + 1442695040888963407ULL;
+    gap = (x >> 62) % 3;
+    end_index += (i < (num_chains / 2)) ? gap : (gap * spread);
+    end_indices[i] = end_index;
+    rainbow_table[i * 2] = i;
+    rainbow_table[(i * 2) + 1] = end_index;
+  }
+
+  for (j = 0; j < num_chains * 3; j++)
+    queries[j] = end_indices[j / 3] + (j % 3) - 1;
+
+  rt_search_table_init(&rst, rainbow_table, num_chains);
+  rt_search_table_lower_bound_many(&rst, queries, num_chains * 3, batch_positions);
+  for (j = 0; j < num_chains * 3; j++) {
+    end_index = queries[j];
+
+    low = 0;
+    high = num_chains;
+    while (low < high) {
+      mid = (low + high) / 2;
+      if (end_indices[mid] < end_index)
+	low = mid + 1;
+      else
+	high = mid;
+    }
+
+    pos = rt_search_table_lower_bound(&rst, end_index);
+    found = rt_search_table_find(&rst, end_index, &start);
+    if ((pos != low) || (batch_positions[j] != low) || (found != ((low < num_chains) && (end_indices[low] == end_index))) || (found && (start != low))) {
+      fprintf(stderr, "\n\nCPU error (table search, %s, %u chains):\n\tEnd index:         %"PRIu64"\n\tExpected position: %u\n\tComputed position: %u\n\tBatch position:    %u\n\n", get_simd_level_name(get_simd_level()), num_chains, end_index, low, pos, batch_positions[j]);
+      test_passed = 0;
+      break;
+    }
+  }
+
+  rt_search_table_free(&rst);
+  free(end_indices);
+  free(queries);
+  free(batch_positions);
+  return test_passed;
+}
+
+
+/* Checks that an empty table can be set up and searched, and that nothing is found
+ * in it. */
+static int cpu_test_rt_search_empty() {
+  uint64_t queries[3] = {0, 1, UINT64_MAX}, start = 0;
+  unsigned int batch_positions[3] = {1, 1, 1}, i = 0;
+  rt_search_table rst;
+  int test_passed = 1;
+
+
+  rt_search_table_init(&rst, NULL, 0);
+  rt_search_table_lower_bound_many(&rst, queries, 3, batch_positions);
+  for (i = 0; i < 3; i++) {
+    if ((rt_search_table_lower_bound(&rst, queries[i]) != 0) || (batch_positions[i] != 0) || rt_search_table_find(&rst, queries[i], &start)) {
+      fprintf(stderr, "\n\nCPU error (table search, %s, empty table):\n\tEnd index: %"PRIu64"\n\n", get_simd_level_name(get_simd_level()), queries[i]);
+      test_passed = 0;
+      break;
+    }
+  }
+
+  rt_search_table_free(&rst);
+  return test_passed;
+}
+
+
+/* The number of hashes, and precomputed end indices per hash, in the join test.  The
+ * hash numbered JOIN_TEST_CRACKED_HASH is treated as cracked. */
+#define JOIN_TEST_HASHES 6
+#define JOIN_TEST_END_INDICES 300
+#define JOIN_TEST_CRACKED_HASH 3
+
+
+/* A match found by one of the search methods in the join test. */
+typedef struct {
+  unsigned int hash_number;
+  unsigned int position;
+  uint64_t start_index;
+} join_test_hit;
+
+
+/* The matches that one search method found. */
+typedef struct {
+  join_test_hit *hits;
+  unsigned int num_hits;
+} join_test_hits;
+
+
+/* Records a match (see rt_search_hit_func). */
+static void join_test_add_hit(void *ctx, unsigned int hash_number, unsigned int position, uint64_t start_index) {
+  join_test_hits *jth = (join_test_hits *)ctx;
+
+
+  if (jth->num_hits < (JOIN_TEST_HASHES * JOIN_TEST_END_INDICES)) {
+    jth->hits[jth->num_hits].hash_number = hash_number;
+    jth->hits[jth->num_hits].position = position;
+    jth->hits[jth->num_hits].start_index = start_index;
+  }
+  jth->num_hits++;
+}
+
+
+/* Sorts join test hits by hash, then by position (for qsort()). */
+static int compare_join_test_hits(const void *a, const void *b) {
+  const join_test_hit *ha = (const join_test_hit *)a, *hb = (const join_test_hit *)b;
+
+  if (ha->hash_number != hb->hash_number)
+    return (ha->hash_number < hb->hash_number) ? -1 : 1;
+  else if (ha->position != hb->position)
+    return (ha->position < hb->position) ? -1 : 1;
+  return 0;
+}
+
+
+/* Checks that one search method found exactly the expected matches. */
+static int join_test_compare(join_test_hits *expected, join_test_hits *actual, const char *method, unsigned int num_chains) {
+  qsort(actual->hits, (actual->num_hits < (JOIN_TEST_HASHES * JOIN_TEST_END_INDICES)) ? actual->num_hits : (JOIN_TEST_HASHES * JOIN_TEST_END_INDICES), sizeof(join_test_hit), compare_join_test_hits);
+  if ((actual->num_hits != expected->num_hits) || (memcmp(actual->hits, expected->hits, expected->num_hits * sizeof(join_test_hit)) != 0)) {
+    fprintf(stderr, "\n\nCPU error (table search, %s, %s, %u chains):\n\tExpected hits: %u\n\tComputed hits: %u\n\n", get_simd_level_name(get_simd_level()), method, num_chains, expected->num_hits, actual->num_hits);
+    return 0;
+  }
+  return 1;
+}
+
+
+/* Checks that the tree search, the merge join, and the hash join all find the same
+ * matches as a linear scan, on a table with duplicate end indices (where only the
+ * first chain counts).  Some precomputed end indices are repeated, both within a hash
+ * and across hashes, and one hash is cracked (so none of its matches count).  Each
+ * method's work is split into two chunks, to check that they can start in the
+ * middle. */
+static int cpu_test_rt_search_joins(unsigned int num_chains) {
+  uint64_t *rainbow_table = NULL, *end_indices = NULL, *queries = NULL;
+  uint64_t end_index = 0, x = 1;
+  unsigned char skip_hashes[JOIN_TEST_HASHES] = {0};
+  unsigned int h = 0, i = 0, t = 0, split = 0, total = JOIN_TEST_HASHES * JOIN_TEST_END_INDICES;
+  rt_tagged_end_index *sorted_end_indices = NULL;
+  rt_end_index_set set = {0};
+  join_test_hits expected = {0}, tree = {0}, merge = {0}, hash = {0};
+  rt_search_table rst;
+  int test_passed = 1;
+
+
+  rainbow_table = calloc(num_chains * 2, sizeof(uint64_t));
+  end_indices = calloc(num_chains, sizeof(uint64_t));
+  queries = calloc(total, sizeof(uint64_t));
+  sorted_end_indices = calloc(total, sizeof(rt_tagged_end_index));
+  expected.hits = calloc(total, sizeof(join_test_hit));
+  tree.hits = calloc(total, sizeof(join_test_hit));
+  merge.hits = calloc(total, sizeof(join_test_hit));
+  hash.hits = calloc(total, sizeof(join_test_hit));
+  if ((rainbow_table == NULL) || (end_indices == NULL) || (queries == NULL) || (sorted_end_indices == NULL) || (expected.hits == NULL) || (tree.hits == NULL) || (merge.hits == NULL) || (hash.hits == NULL) || !rt_end_index_set_init(&set, total)) {
+    fprintf(stderr, "Failed to allocate test table.\n");
+    exit(-1);
+  }
+
+  /* Each end index is 0, 1, or 2 more than the previous one, so about a third of the
+   * chains share their end index with the one before. */
+  for (i = 0; i < num_chains; i++) {
+    x = (x * 6364136223846793005ULL) + 1442695040888963407ULL;
+    end_index += (x >> 62) % 3;
+    end_indices[i] = end_index;
+    rainbow_table[i * 2] = i;
+    rainbow_table[(i * 2) + 1] = end_index;
+  }
+
+  /* Hash h's precomputed end indices are at queries[h * JOIN_TEST_END_INDICES].  Most
+   * are random values within the table's range (so about half match).  Every hash
+   * repeats the first few of hash 0's, and the last few of each hash repeat its own. */
+  for (h = 0; h < JOIN_TEST_HASHES; h++) {
+    for (i = 0; i < JOIN_TEST_END_INDICES; i++) {
+      x = (x * 6364136223846793005ULL) + 1442695040888963407ULL;
+      if (i < 10)
+	queries[(h * JOIN_TEST_END_INDICES) + i] = end_indices[(i * 7) % num_chains];
+      else if (i >= (JOIN_TEST_END_INDICES - 10))
+	queries[(h * JOIN_TEST_END_INDICES) + i] = queries[(h * JOIN_TEST_END_INDICES) + i - 20];
+      else
+	queries[(h * JOIN_TEST_END_INDICES) + i] = (x >> 32) % (end_index + 2);
+    }
+  }
+  skip_hashes[JOIN_TEST_CRACKED_HASH] = 1;
+
+  /* The expected matches: the first chain with the same end index, for every
+   * precomputed end index of the uncracked hashes. */
+  for (h = 0; h < JOIN_TEST_HASHES; h++) {
+    if (skip_hashes[h])
+      continue;
+
+    for (i = 0; i < JOIN_TEST_END_INDICES; i++) {
+      for (t = 0; (t < num_chains) && (end_indices[t] != queries[(h * JOIN_TEST_END_INDICES) + i]); t++)
+	;
+      if (t < num_chains)
+	join_test_add_hit(&expected, h, i, t);
+    }
+  }
+
+  rt_search_table_init(&rst, rainbow_table, num_chains);
+
+  /* Tree search, with each hash split into two chunks.  As in crackalack_lookup,
+   * cracked hashes aren't searched for at all. */
+  split = JOIN_TEST_END_INDICES / 3;
+  for (h = 0; h < JOIN_TEST_HASHES; h++) {
+    if (!skip_hashes[h]) {
+      rt_search_table_find_many(&rst, &(queries[h * JOIN_TEST_END_INDICES]), split, h, 0, &join_test_add_hit, &tree);
+      rt_search_table_find_many(&rst, &(queries[(h * JOIN_TEST_END_INDICES) + split]), JOIN_TEST_END_INDICES - split, h, split, &join_test_add_hit, &tree);
+    }
+  }
+
+  /* Merge join, split in the middle of a run of duplicate precomputed end indices if
+   * there is one. */
+  for (h = 0; h < JOIN_TEST_HASHES; h++) {
+    for (i = 0; i < JOIN_TEST_END_INDICES; i++) {
+      sorted_end_indices[(h * JOIN_TEST_END_INDICES) + i].end_index = queries[(h * JOIN_TEST_END_INDICES) + i];
+      sorted_end_indices[(h * JOIN_TEST_END_INDICES) + i].hash_number = h;
+      sorted_end_indices[(h * JOIN_TEST_END_INDICES) + i].position = i;
+    }
+  }
+  qsort(sorted_end_indices, total, sizeof(rt_tagged_end_index), rt_compare_tagged_end_indices);
+
+  for (split = total / 3; (split < total) && (sorted_end_indices[split - 1].end_index != sorted_end_indices[split].end_index); split++)
+    ;
+  rt_search_table_merge_join(&rst, sorted_end_indices, 0, split, skip_hashes, &join_test_add_hit, &merge);
+  rt_search_table_merge_join(&rst, sorted_end_indices, split, total, skip_hashes, &join_test_add_hit, &merge);
+
+  /* Hash join, split in the middle of a run of duplicate table end indices if there is
+   * one. */
+  for (h = 0; h < JOIN_TEST_HASHES; h++) {
+    for (i = 0; i < JOIN_TEST_END_INDICES; i++)
+      rt_end_index_set_add(&set, queries[(h * JOIN_TEST_END_INDICES) + i], h, i);
+  }
+
+  for (split = (num_chains / 3) + 1; (split < num_chains) && (end_indices[split - 1] != end_indices[split]); split++)
+    ;
+  rt_search_table_hash_join(&rst, &set, 0, split, skip_hashes, &join_test_add_hit, &hash);
+  rt_search_table_hash_join(&rst, &set, split, num_chains, skip_hashes, &join_test_add_hit, &hash);
+
+  qsort(expected.hits, expected.num_hits, sizeof(join_test_hit), compare_join_test_hits);
+  test_passed &= join_test_compare(&expected, &tree, "tree search", num_chains);
+  test_passed &= join_test_compare(&expected, &merge, "merge join", num_chains);
+  test_passed &= join_test_compare(&expected, &hash, "hash join", num_chains);
+
+  rt_search_table_free(&rst);
+  rt_end_index_set_free(&set);
+  free(end_indices);
+  free(queries);
+  free(sorted_end_indices);
+  free(expected.hits);
+  free(tree.hits);
+  free(merge.hits);
+  free(hash.hits);
+  return test_passed;
+}
+
+
+/* Runs the table search tests at each SIMD level this CPU supports. */
+int test_rt_search() {
+  int tests_passed = 1;
+  unsigned int i = 0, level = 0, original_level = get_simd_level();
+
+
+  for (level = SIMD_SCALAR; level <= get_simd_level_supported(); level++) {
+    set_simd_level(level);
+    tests_passed &= cpu_test_rt_search_empty();
+    for (i = 0; i < (sizeof(rt_search_test_sizes) / sizeof(unsigned int)); i++) {
+      tests_passed &= cpu_test_rt_search(rt_search_test_sizes[i], 1);
+      tests_passed &= cpu_test_rt_search(rt_search_test_sizes[i], 1ULL << 40);
+    }
+    tests_passed &= cpu_test_rt_search_joins(1);
+    tests_passed &= cpu_test_rt_search_joins(1000);
+  }
+
+  set_simd_level(original_level);
+
+  return tests_passed;
+}
@@ -0,0 +1,6 @@
+#ifndef TEST_RT_SEARCH_H
+#define TEST_RT_SEARCH_H
+
+int test_rt_search();
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * Rainbow Crackalack: thread_pool.c
+ * Copyright (C) 2018-2020  Joe Testa <jtesta@positronsecurity.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms version 3 of the GNU General Public License as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* A persistent pool of worker threads.  Creating and joining a set of threads for
+ * every table adds latency, and the new threads lose whatever was in their cores'
+ * caches; the pool's workers are instead started once, and one for each CPU the process
+ * may run on is pinned to that CPU. */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "misc.h"
+#include "thread_pool.h"
+
+
+#define LOCK_POOL(_tp) \
+  if (pthread_mutex_lock(&((_tp)->lock))) { perror("Failed to lock mutex"); exit(-1); }
+
+#define UNLOCK_POOL(_tp) \
+  if (pthread_mutex_unlock(&((_tp)->lock))) { perror("Failed to unlock mutex"); exit(-1); }
+
+
+/* Runs tasks from the queue until the pool is shut down. */
+static void *thread_pool_worker(void *ptr) {
+  thread_pool *tp = (thread_pool *)ptr;
+  thread_pool_task *task = NULL;
+  thread_pool_group *group = NULL;
+
+
+  LOCK_POOL(tp);
+  while (1) {
+    while ((tp->queue_head == NULL) && !tp->shutdown)
+      pthread_cond_wait(&(tp->task_available), &(tp->lock));
+
+    /* Only exit once the queue is drained. */
+    if (tp->queue_head == NULL)
+      break;
+
+    task = tp->queue_head;
+    tp->queue_head = task->next;
+    if (tp->queue_head == NULL)
+      tp->queue_tail = NULL;
+    UNLOCK_POOL(tp);
+
+    group = task->group;
+    task->func(task->arg);
+    FREE(task);
+
+    LOCK_POOL(tp);
+    group->num_outstanding--;
+    if (group->num_outstanding == 0)
+      pthread_cond_broadcast(&(tp->tasks_done));
+  }
+  UNLOCK_POOL(tp);
+
+  return NULL;
+}
+
+
+/* Pins a worker thread to the n-th CPU in the process's affinity set (which may be
+ * restricted by taskset, cgroups, etc.).  Returns without pinning if the set has n or
+ * fewer CPUs, or if the affinity can't be read or set; this is only a hint. */
+static void pin_thread(pthread_t thread, unsigned int n) {
+#ifdef __linux__
+  cpu_set_t allowed_set, cpu_set;
+  unsigned int cpu = 0, num_seen = 0;
+
+
+  CPU_ZERO(&allowed_set);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed_set) != 0)
+    return;
+
+  for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &allowed_set))
+      continue;
+
+    if (num_seen == n) {
+      CPU_ZERO(&cpu_set);
+      CPU_SET(cpu, &cpu_set);
+      pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpu_set);
+      return;
+    }
+    num_seen++;
+  }
+#else
+  (void)thread;
+  (void)n;
+#endif
+}
+
+
+/* Creates a pool with the specified number of worker threads.  The first one for each
+ * CPU in the process's affinity set is pinned to that CPU.  Any beyond that are left
+ * to the OS scheduler, since pinning them would put two workers on some CPUs (these
+ * extra workers are for tasks that mostly sleep, such as waiting on GPUs or on other
+ * tasks). */
+thread_pool *thread_pool_create(unsigned int num_threads) {
+  thread_pool *tp = NULL;
+  unsigned int i = 0;
+
+
+  tp = calloc(1, sizeof(thread_pool));
+  if (tp == NULL) {
+    fprintf(stderr, "Failed to allocate thread pool.\n");
+    exit(-1);
+  }
+
+  if (num_threads == 0)
+    num_threads = 1;
+
+  tp->threads = calloc(num_threads, sizeof(pthread_t));
+  if (tp->threads == NULL) {
+    fprintf(stderr, "Failed to allocate thread pool.\n");
+    exit(-1);
+  }
+
+  if ((pthread_mutex_init(&(tp->lock), NULL) != 0) || (pthread_cond_init(&(tp->task_available), NULL) != 0) || (pthread_cond_init(&(tp->tasks_done), NULL) != 0)) {
+    fprintf(stderr, "Failed to initialize thread pool locks.\n");
+    exit(-1);
+  }
+
+  for (i = 0; i < num_threads; i++) {
+    if (pthread_create(&(tp->threads[i]), NULL, &thread_pool_worker, tp)) {
+      perror("Failed to create thread");
+      exit(-1);
+    }
+
+    pin_thread(tp->threads[i], i);
+    tp->num_threads++;
+  }
+
+  return tp;
+}
+
+
+/* Finishes any queued tasks, then stops the worker threads and frees the pool. */
+void thread_pool_destroy(thread_pool *tp) {
+  unsigned int i = 0;
+
+
+  if (tp == NULL)
+    return;
+
+  LOCK_POOL(tp);
+  tp->shutdown = 1;
+  pthread_cond_broadcast(&(tp->task_available));
+  UNLOCK_POOL(tp);
+
+  for (i = 0; i < tp->num_threads; i++) {
+    if (pthread_join(tp->threads[i], NULL) != 0) {
+      perror("Failed to join with thread");
+      exit(-1);
+    }
+  }
+
+  pthread_cond_destroy(&(tp->tasks_done));
+  pthread_cond_destroy(&(tp->task_available));
+  pthread_mutex_destroy(&(tp->lock));
+  FREE(tp->threads);
+  FREE(tp);
+}
+
+
+/* Queues a task in a group, to be run by the next free worker thread.  Tasks may
+ * submit and wait on groups of their own, as long as the pool has enough workers for
+ * all the tasks that wait at once. */
+void thread_pool_submit(thread_pool *tp, thread_pool_group *group, thread_pool_func func, void *arg) {
+  thread_pool_task *task = calloc(1, sizeof(thread_pool_task));
+
+
+  if (task == NULL) {
+    fprintf(stderr, "Failed to allocate thread pool task.\n");
+    exit(-1);
+  }
+  task->func = func;
+  task->arg = arg;
+  task->group = group;
+
+  LOCK_POOL(tp);
+  if (tp->queue_tail == NULL)
+    tp->queue_head = task;
+  else
+    tp->queue_tail->next = task;
+  tp->queue_tail = task;
+  group->num_outstanding++;
+
+  pthread_cond_signal(&(tp->task_available));
+  UNLOCK_POOL(tp);
+}
+
+
+/* Waits until all the tasks submitted in a group have finished. */
+void thread_pool_wait(thread_pool *tp, thread_pool_group *group) {
+  LOCK_POOL(tp);
+  while (group->num_outstanding > 0)
+    pthread_cond_wait(&(tp->tasks_done), &(tp->lock));
+  UNLOCK_POOL(tp);
+}
@@ -0,0 +1,52 @@
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <pthread.h>
+
+
+/* Tasks have the same signature as thread functions, so that the same function can be
+ * used either way.  The return value is ignored. */
+typedef void *(*thread_pool_func)(void *);
+
+
+/* A set of tasks that can be waited on together, independently of any other tasks
+ * in the pool. */
+struct _thread_pool_group {
+  unsigned int num_outstanding;  /* The number of the group's tasks queued or running. */
+};
+typedef struct _thread_pool_group thread_pool_group;
+
+
+struct _thread_pool_task {
+  thread_pool_func func;
+  void *arg;
+  thread_pool_group *group;
+  struct _thread_pool_task *next;
+};
+typedef struct _thread_pool_task thread_pool_task;
+
+
+/* A fixed set of worker threads that run tasks from a queue.  The workers are created
+ * once and live until the pool is destroyed.  On Linux, the first worker for each CPU
+ * the process may run on is pinned to it. */
+struct _thread_pool {
+  pthread_t *threads;
+  unsigned int num_threads;
+
+  pthread_mutex_t lock;
+  pthread_cond_t task_available;  /* Signaled when a task is queued, or on shutdown. */
+  pthread_cond_t tasks_done;      /* Signaled when a group's tasks are all done. */
+
+  thread_pool_task *queue_head;
+  thread_pool_task *queue_tail;
+  unsigned int shutdown;
+};
+typedef struct _thread_pool thread_pool;
+
+
+thread_pool *thread_pool_create(unsigned int num_threads);
+void thread_pool_destroy(thread_pool *tp);
+void thread_pool_submit(thread_pool *tp, thread_pool_group *group, thread_pool_func func, void *arg);
+void thread_pool_wait(thread_pool *tp, thread_pool_group *group);
+
+#endif
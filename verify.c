@@ -25,6 +25,7 @@
 #include "charset.h"
 #include "cpu_rt_functions.h"
 #include "file_lock.h"
+#include "hash_provider.h"
 #include "misc.h"
 #include "rtc_decompress.h"
 #include "shared.h"
@@ -35,6 +36,31 @@ void _print_chain_error(uint64_t random_chain, uint64_t start, uint64_t actual_e
   fprintf(stderr, "Error: chain #%"PRIu64" is invalid!\n  Start index:        %"PRIu64"\n  Actual chain end:   %"PRIu64"\n  Computed chain end: %"PRIu64"\n\n", random_chain, start, actual_end, computed_end);
 }
 
+/* Re-generates a set of chains (up to CHAIN_BATCH_SIZE of them) in one batch, so that
+ * all SIMD lanes are used, and compares them against the end indices from the table.
+ * The chain numbers are only used in the error message.  Returns 1 if all chains
+ * match, or 0 if any do not. */
+int _verify_chains(rt_parameters *rt_params, char *charset, uint64_t *plaintext_space_up_to_index, uint64_t plaintext_space_total, uint64_t *chain_nums, uint64_t *starts, uint64_t *actual_ends, unsigned int num_chains) {
+  uint64_t computed_ends[CHAIN_BATCH_SIZE] = {0};
+  unsigned int i = 0;
+
+
+  for (i = 0; i < num_chains; i++)
+    computed_ends[i] = starts[i];
+
+  generate_rainbow_chains(rt_params->hash_type, charset, strlen(charset), rt_params->plaintext_len_min, rt_params->plaintext_len_max, rt_params->reduction_offset, 0, rt_params->chain_len, computed_ends, num_chains, plaintext_space_up_to_index, plaintext_space_total);
+
+  for (i = 0; i < num_chains; i++) {
+    if (actual_ends[i] != computed_ends[i]) {
+      _print_chain_error(chain_nums[i], starts[i], actual_ends[i], computed_ends[i]);
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+
 /* Verifies a rainbow table already loaded from disk. */
 int verify_rainbowtable(uint64_t *rainbowtable, unsigned int num_chains, unsigned int table_type, uint64_t expected_start, uint64_t plaintext_space_total, unsigned int *error_chain_num) {
   unsigned int i = 0;
@@ -201,32 +227,29 @@ int verify_rainbowtable_file(char *filename, unsigned int table_type, unsigned i
 
   /* Handle the case of a quick table verification up-front. */
   if (table_type == VERIFY_TABLE_TYPE_QUICK) {
-    uint64_t random_chain = 0, start = 0, actual_end = 0, computed_end = 0;
-    char plaintext[MAX_PLAINTEXT_LEN] = {0};
-    unsigned char hash[MAX_HASH_OUTPUT_LEN] = {0};
-    unsigned int i = 0, plaintext_len = sizeof(plaintext), hash_len = sizeof(hash);
+    uint64_t random_chains[5] = {0}, starts[5] = {0}, actual_ends[5] = {0};
+    unsigned int i = 0;
 
 
     /* The actual number of chains in the file. */
     actual_num_chains = file_size / CHAIN_SIZE;
 
-    /* Only verify 5 chains. */
-    for (i = 0; i < 5; i++) {
-      random_chain = get_random(actual_num_chains);
-      rc_fseek(f, random_chain * (sizeof(uint64_t) * 2), RCSEEK_SET); /* Jump to random chain. */
+    /* Only verify 5 chains, and only if this hash type has a CPU implementation. */
+    if (get_hash_provider(rt_params.hash_type) != NULL) {
 
-      /* Read start & end point from random chain in file. */
-      rc_fread(&start, sizeof(uint64_t), 1, f);
-      rc_fread(&actual_end, sizeof(uint64_t), 1, f);
+      /* Read the start & end points of the random chains from the file, then
+       * ensure that the end points match what we compute. */
+      for (i = 0; i < 5; i++) {
+	random_chains[i] = get_random(actual_num_chains);
+	rc_fseek(f, random_chains[i] * (sizeof(uint64_t) * 2), RCSEEK_SET); /* Jump to random chain. */
 
-      /* Compute the expected end point. */
-      computed_end = generate_rainbow_chain(rt_params.hash_type, charset, strlen(charset), rt_params.plaintext_len_min, rt_params.plaintext_len_max, rt_params.reduction_offset, rt_params.chain_len, start, plaintext_space_up_to_index, plaintext_space_total, plaintext, &plaintext_len, hash, &hash_len);
+	rc_fread(&(starts[i]), sizeof(uint64_t), 1, f);
+	rc_fread(&(actual_ends[i]), sizeof(uint64_t), 1, f);
+      }
 
-      /* Ensure that the end point in the file matches what we just computed. */
-      if (actual_end != computed_end) {
-        _print_chain_error(random_chain, start, actual_end, computed_end);
-        rc_fclose(f);
-        return 0;
+      if (!_verify_chains(&rt_params, charset, plaintext_space_up_to_index, plaintext_space_total, random_chains, starts, actual_ends, 5)) {
+	rc_fclose(f);
+	return 0;
       }
     }
 
@@ -289,29 +312,29 @@ int verify_rainbowtable_file(char *filename, unsigned int table_type, unsigned i
   }
 
   if (num_chains_to_verify > 0) {
-    uint64_t start = 0, computed_end = 0, actual_end = 0, random_chain = 0;
-    char plaintext[MAX_PLAINTEXT_LEN] = {0};
-    unsigned char hash[MAX_HASH_OUTPUT_LEN] = {0};
-    unsigned int i = 0, plaintext_len = sizeof(plaintext), hash_len = sizeof(hash);
+    uint64_t random_chains[CHAIN_BATCH_SIZE] = {0}, starts[CHAIN_BATCH_SIZE] = {0}, actual_ends[CHAIN_BATCH_SIZE] = {0};
+    unsigned int i = 0, num_batched = 0;
 
 
-    if (rt_params.hash_type == HASH_NTLM) {
-      for (i = 0; i < num_chains_to_verify; i++) {
-	random_chain = get_random(actual_num_chains);
-	/*printf("  Verifying chain #%"PRIu64"...\n", random_chain);*/
+    if (get_hash_provider(rt_params.hash_type) != NULL) {
 
-	start = rainbow_table[random_chain * 2];
-	actual_end = rainbow_table[(random_chain * 2) + 1];
+      /* Pick the random chains in batches, and verify each batch at once. */
+      for (i = 0; i < num_chains_to_verify; i++) {
+	random_chains[num_batched] = get_random(actual_num_chains);
+	/*printf("  Verifying chain #%"PRIu64"...\n", random_chains[num_batched]);*/
 
-	computed_end = generate_rainbow_chain(rt_params.hash_type, charset, strlen(charset), rt_params.plaintext_len_min, rt_params.plaintext_len_max, rt_params.reduction_offset, rt_params.chain_len, start, plaintext_space_up_to_index, plaintext_space_total, plaintext, &plaintext_len, hash, &hash_len);
+	starts[num_batched] = rainbow_table[random_chains[num_batched] * 2];
+	actual_ends[num_batched] = rainbow_table[(random_chains[num_batched] * 2) + 1];
+	num_batched++;
 
-	if (actual_end != computed_end) {
-          _print_chain_error(random_chain, start, actual_end, computed_end);
-	  goto err;
+	if ((num_batched == CHAIN_BATCH_SIZE) || (i == (num_chains_to_verify - 1))) {
+	  if (!_verify_chains(&rt_params, charset, plaintext_space_up_to_index, plaintext_space_total, random_chains, starts, actual_ends, num_batched))
+	    goto err;
+	  num_batched = 0;
 	}
       }
     } else {
-      printf("Note: skipping CPU chain verification since hash type is not NTLM.\n"); fflush(stdout);
+      printf("Note: skipping CPU chain verification since this hash type has no CPU implementation.\n"); fflush(stdout);
     }
   }
 